@@ -18,6 +18,25 @@
 #define ENABLE_CAMERA 1         // 是否启用摄像头
 #define ENABLE_GPS 0           // 是否启用GPS
 #define ENABLE_DEEP_SLEEP 0     // 深度睡眠 ← 0=关闭(测试中), 1=启用(生产)
+#define ENABLE_TELEMETRY_QUEUE 1 // 断网缓存队列 (LittleFS)，联网后批量补发
+#define ENABLE_HEARTBEAT_BATCH 1 // 心跳批量模式：每次唤醒只采样，K 次唤醒联网一次
+#define ENABLE_DELTA_REPORT 1    // 变化驱动上报：读数均在死区内时跳过心跳
+#define ENABLE_WAKE_STUB 1       // 唤醒桩：定时唤醒先在 RTC 中检查倾角（需深度睡眠 + 真实硬件）
+#define ENABLE_FAST_BOOT 1       // 快速启动：固定延时改为就绪轮询，IMU 地址/配置缓存在 RTC
+#define ENABLE_POWER_MANAGEMENT 1 // 分阶段调频 + 自动 Light-sleep (见 PowerManager.h)
+#define ENABLE_SOUND_CLASSIFIER 1 // 噪音报警前做频谱分类，风/雨/交通不报警
+#define ENABLE_ADAPTIVE_NOISE_FLOOR 1 // 噪音阈值跟随本地基线（RTC 内存，按小时分桶）
+#define ENABLE_AUDIO_CLIP 1       // 噪音报警附带 ADPCM 录音片段（PSRAM 环形缓冲）
+#define ENABLE_ULP_SOUND 1        // 深度睡眠期间由 ULP 监测声音（需深度睡眠 + 真实硬件）
+#define ENABLE_IMU_FIFO 1         // 倾角取睡眠期间 IMU FIFO 缓存样本的均值（突发读取）
+#define ENABLE_TILT_INTERRUPT 1   // IMU wake-up 中断经 INT1 触发 EXT1 唤醒，倾斜即时报警
+#define ENABLE_TILT_FUSION 1      // 倾角由陀螺仪 + 加速度计互补滤波得到，抑制风摆误报
+#define ENABLE_TILT_TREND 1       // 日均倾角线性回归，预计即将越过阈值时发出蠕变报警
+#define ENABLE_CAM_AE_CACHE 1     // 相机曝光/增益存 RTC，下次初始化写回并跳过预热帧
+#define ENABLE_CAM_BURST 1        // 报警拍照连拍多帧，按清晰度评分只保留最优一帧
+#define ENABLE_IMAGE_TIERS 1      // 报警只传灰度缩略图，原图缓存 LittleFS，服务器请求时再传
+#define ENABLE_CAM_RATE_CONTROL 1 // 按字节预算和上次照片大小自动调整 JPEG 质量
+#define ENABLE_SCENE_CHANGE 1     // 报警照片与参考画面比较，未变化时不重复上传原图
 
 // ==================== 调试宏 ====================
 // ==================== 调试系统配置 ====================
@@ -70,7 +89,9 @@ enum SystemState {
   STATE_EVALUATE,
   STATE_ALARM,
   STATE_SLEEP,
-  STATE_ERROR
+  STATE_ERROR,
+  STATE_REPORT, // 心跳上报（RTC 中按数值保存状态，只允许在末尾追加）
+  STATE_COUNT
 };
 
 // ==================== 报警类型 ====================
@@ -87,3 +87,5 @@
 
 #define PIN_LSM_SDA PIN_I2C_BUS0_SDA
 #define PIN_LSM_SCL PIN_I2C_BUS0_SCL
+// INT1: U1.18 -> IO10 (RTC_GPIO10，可作 EXT1 深度睡眠唤醒，高电平有效)
+#define PIN_LSM_INT1 10
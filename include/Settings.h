@@ -20,13 +20,43 @@
 
 // 分辨率和质量 (参考 project-name/main/camera_module.c:45-48)
 #define CAM_FRAME_SIZE FRAMESIZE_QVGA // 分辨率: 320x240
-#define CAM_JPEG_QUALITY 12           // JPEG 压缩质量 (0-63, 越小越好)
+#define CAM_JPEG_QUALITY 12           // JPEG 压缩质量 (0-63, 越小越好)，码率控制的初值
+#define CAM_JPEG_QUALITY_MIN 10       // 码率控制质量下限（过小时 JPEG 可能超出帧缓冲）
+#define CAM_JPEG_QUALITY_MAX 40       // 码率控制质量上限
+#define CAM_JPEG_BUDGET_BYTES 10000   // 单张照片字节预算
+#define CAM_JPEG_BUDGET_LOW_BYTES 5000 // 低电量时的字节预算
+#define CAM_BUDGET_LOW_BAT_PCT 30     // 电量低于此百分比使用低电量预算
+#define CAM_RATE_DEADBAND_PCT 10      // 上次大小偏离预算不超过此比例 (%) 时不调整质量
+#define CAM_RATE_MAX_STEP 6           // 单次质量最大调整量
 #define CAM_FB_COUNT 1                // 帧缓冲数量 (简化为单缓冲)
 
 // 拍照参数
 #define CAM_CAPTURE_RETRY_COUNT 3     // 拍照失败重试次数
 #define CAM_INIT_STABILIZE_MS 300     // 初始化后稳定等待时间 (ms)
 #define CAM_CAPTURE_RETRY_DELAY_MS 50 // 重试间隔 (ms)
+#define CAM_FAST_BOOT_WARMUP_FRAMES 3 // 快速启动：连续丢弃的预热帧数（取帧本身即等待就绪）
+#define CAM_PWDN_SETTLE_MS 2          // 快速启动：PWDN 释放后等待 (ms)
+#define CAM_AE_CACHE_MAX_AGE_SEC 3600 // 曝光记录有效期 (s)，超过则按原流程预热
+#define CAM_AE_CACHE_MAX_DRIFT_PCT 25 // 首帧后 AEC 偏离写回值超过此比例 (%) 则预热重拍
+#define CAM_BURST_FRAMES 4            // 连拍帧数（只上传最清晰的一帧）
+#define CAM_BURST_FB_COUNT 2          // 连拍帧缓冲数量（持有最优帧 + 采集下一帧）
+#define CAM_BURST_SCORE_SCALE 1       // 评分解码降采样: 1=1/2 (JPG_SCALE_2X), 2=1/4, 3=1/8
+
+// 两级图片上传 (缩略图随报警，原图缓存于 LittleFS 按需上传)
+#define IMG_THUMB_WIDTH 96            // 缩略图宽 (px)
+#define IMG_THUMB_HEIGHT 72           // 缩略图高 (px)，保持 QVGA 的 4:3
+#define IMG_THUMB_DECODE_SCALE 1      // 缩略图解码降采样: QVGA → 160x120 再区域平均
+#define IMG_THUMB_QUALITY 60          // 缩略图 JPEG 质量 (fmt2jpg: 1-100, 越大越好)
+#define IMG_CACHE_DIR "/img"          // 原图缓存目录
+#define IMG_CACHE_MAX_FILES 8         // 最多缓存原图数，超出淘汰最旧
+#define IMG_CACHE_RESERVE_BYTES (64 * 1024) // 分区保留空间，留给断网缓存队列
+
+// 画面变化检测 (与参考灰度图逐块比较)
+#define SCENE_REF_PATH "/scene.ref"   // 参考图文件 (LittleFS)
+#define SCENE_DECODE_SCALE 3          // 比较用解码降采样: 3=1/8，QVGA → 40x30（每像素一个 8x8 块）
+#define SCENE_BLOCK_DIFF 12           // 去除整体明暗后块均值差超过此值视为变化块 (0-255)
+#define SCENE_CHANGE_MIN_PCT 5        // 变化块占比达到此值 (%) 视为画面已变
+#define SCENE_UNCHANGED_SKIP 0        // 画面未变化时: 1=不上传照片, 0=只上传缩略图
 
 // Mock 摄像头参数 (仅仿真使用)
 #define MOCK_CAM_JPEG_MIN_SIZE 2048   // 模拟 JPEG 最小大小 (bytes)
@@ -58,6 +88,7 @@
 #define GPS_INIT_DELAY_MS 1000      // 模块启动稳定时间 (ms)
 #define GPS_TIMEOUT_MS 30000        // 搜星超时时间 (ms)
 #define GPS_UPDATE_INTERVAL_MS 1000 // 位置更新间隔 (ms)
+#define GPS_READY_TIMEOUT_MS 1500   // 快速启动：等待首个 NMEA 字节的上限 (ms)
 #define GPS_UPLOAD_INTERVAL_MS                                                 \
   60000 // GPS 定时上传间隔 (60s, 参考 project-name)
 #define TILT_GPS_SKIP_DURATION_MS 30000 // 倾斜后跳过 GPS 上传的时长 (30s)
@@ -68,8 +99,40 @@
 // ║                    📐 倾斜传感器 (LSM6DS3)                         ║
 // ╚══════════════════════════════════════════════════════════════════╝
 #define TILT_THRESHOLD 5.0f        // 倾斜报警角度 (度)
-#define TILT_DEBOUNCE_COUNT 5      // 防抖采样次数
-#define TILT_SAMPLE_INTERVAL_MS 50 // 采样间隔 (ms)
+#define TILT_DEBOUNCE_COUNT 5      // 防抖检查点数（全部超阈值才报警）
+#define TILT_SAMPLE_INTERVAL_MS 50 // 检查点间隔 (ms)
+#define IMU_READY_TIMEOUT_MS 100   // 快速启动：等待 WHO_AM_I / 首个数据就绪的上限 (ms)
+
+// 倾斜中断退避 (ENABLE_TILT_INTERRUPT)：风摆导致反复误唤醒时暂停 EXT1
+#define TILT_WAKE_FALSE_LIMIT 3        // 两次巡检之间误唤醒达到此次数后退避
+#define TILT_WAKE_HOLDOFF_SEC 1800     // 退避时长 (秒)，期间倾斜由定时巡检检查
+
+// FIFO 批量采集 (ENABLE_IMU_FIFO)：睡眠期间 IMU 自行缓存加速度，唤醒后突发读出
+#define IMU_FIFO_ODR_CODE 0x02      // FIFO 写入速率 (FIFO_CTRL5.ODR_FIFO): 1=12.5Hz 2=26Hz
+#define IMU_FIFO_MAX_SAMPLES 512    // 唤醒时保留的最新样本数（每样本 6 字节）
+#define IMU_FIFO_MIN_SAMPLES 8      // FIFO 样本少于此数时改读输出寄存器
+#define IMU_I2C_HZ 100000           // IMU 总线常规 I2C 时钟 (Hz)，与相机 SCCB 共用总线
+#define IMU_I2C_BURST_HZ 400000     // 排空 FIFO 时的 I2C 时钟 (Hz)，结束后恢复原时钟
+
+// 陀螺仪融合 (ENABLE_TILT_FUSION)：防抖窗口内以 104 Hz 做互补滤波（见 TiltFusion.h）
+#define TILT_FUSION_TAU_S 1.0f          // 互补滤波时间常数 (s)，越大越信任陀螺仪
+#define TILT_FUSION_SEED_SAMPLES 26     // 中断唤醒时初值只取最新 FIFO 样本数 (≈1s @26Hz)
+#define TILT_FUSION_ACCEL_GATE_G 0.15f  // |a| 偏离 1g 超过此值时该样本不用加速度修正
+#define IMU_GYRO_SETTLE_MS 80           // 陀螺仪上电稳定时间 (ms)
+#define IMU_GYRO_BIAS_SAMPLES 64        // 零偏校准平均样本数
+
+// 缓慢蠕变趋势 (ENABLE_TILT_TREND)：日均倾角滑动窗口线性回归（见 TiltTrend.h）
+#define TREND_WINDOW_DAYS 90                // 回归窗口（日均值个数，≤255）
+#define TREND_MIN_DAYS 14                   // 窗口少于此天数不做预测
+#define TREND_MIN_SLOPE_DEG_PER_DAY 0.005f  // 低于此斜率视为稳定 (°/天)
+#define TREND_HORIZON_DAYS 60               // 预计到达 TILT_THRESHOLD 的天数小于此值时报警
+#define TREND_ALARM_COOLDOWN_DAYS 7         // 蠕变报警最短间隔 (天)
+
+// 唤醒桩 (ENABLE_WAKE_STUB)：睡眠期间定期只读 IMU，倾角正常则直接回睡
+#define WAKE_STUB_INTERVAL_SEC 60       // 唤醒桩检查间隔 (秒)
+#define WAKE_STUB_TILT_MARGIN 0.5f      // 唤醒桩阈值 = TILT_THRESHOLD - 余量 (度)
+#define WAKE_STUB_I2C_HALF_PERIOD_US 5  // 软件 I2C 半周期 (≈100kHz)
+#define WAKE_STUB_ACTIVE_US 3000        // 单次唤醒桩活动时长估算（能耗账本用）
 
 // ╔══════════════════════════════════════════════════════════════════╗
 // ║                    🔊 音频传感器 (麦克风 + ADC)                     ║
@@ -80,11 +143,50 @@
 //   60 dB = 大声说话
 //   70 dB = 非常吵闹
 //   80 dB = 施工噪音
-#define NOISE_THRESHOLD_DB 45        // 噪音报警阈值（分贝）
+#define NOISE_THRESHOLD_DB 45        // 噪音报警阈值（分贝）；自适应基线未学好前使用
+
+// 【自适应基线】报警 = 超出本地基线 K 个标准差（见 NoiseFloor.h）
+#define NOISE_FLOOR_BINS 24              // 按小时分桶
+#define NOISE_FLOOR_TAU 48               // 滑动平均等效样本数
+#define NOISE_FLOOR_WARMUP 8             // 桶内样本数达到后才启用该桶
+#define NOISE_FLOOR_K_SIGMA 3.0f         // 超出基线的标准差倍数
+#define NOISE_FLOOR_MIN_MARGIN_DB 6.0f   // 超出基线的最小余量 (dB)，防止安静处 σ 过小
+
+// 【校准】dB(A) = 20·log10(A 计权 RMS 计数) + 偏移；用声级计对照 1 kHz 声源调整
+#define AUDIO_DBA_OFFSET 39.0f       // 默认值与旧峰峰值估算在正弦信号下一致
+
+// 连续模式 ADC (DMA)
+#define AUDIO_ADC_CHANNEL 7          // GPIO8 = ADC1_CH7
+#define AUDIO_SAMPLE_RATE_HZ 16000   // 固定采样率 (Hz)
+#define AUDIO_WINDOW_SAMPLES 2048    // 每次测量的窗口长度（16kHz 下 128ms，约等于 Fast 时间计权）
+#define AUDIO_DMA_FRAME_SAMPLES 256  // DMA 单帧样本数
+#define AUDIO_DMA_RING_FRAMES 4      // 驱动环形缓冲帧数
+#define AUDIO_READ_TIMEOUT_MS 300    // 取满一个窗口的超时 (ms)
+
+// 声级计（Leq / Lmax）
+#define AUDIO_LEVEL_SETTLE_SAMPLES 128     // A 计权滤波器建立期，不计入统计（8ms）
+#define AUDIO_LEVEL_SUBWINDOW_SAMPLES 256  // Lmax 子窗口长度（16ms）
 
-// 内部参数（无需修改）
-#define NOISE_SAMPLE_COUNT 50        // 采样次数
-#define NOISE_SAMPLE_INTERVAL_US 200 // 采样间隔（微秒）
+// 声音分类（Leq 超标后判定类别，见 SoundClassifier.h）
+#define SOUND_FFT_SIZE 512                       // FFT 点数（2 的幂，16kHz 下 31.25Hz/bin）
+#define SOUND_BAND_EDGES_HZ {250.0f, 1000.0f, 4000.0f} // 4 个频带的分界
+#define SOUND_CLASS_MAX_DISTANCE 0.35f           // 超过此距离判为 unknown（照常报警）
+// 不报警的类别位掩码: bit1=机械 bit2=风 bit3=雨 bit4=交通
+#define SOUND_SUPPRESS_MASK ((1 << 2) | (1 << 3) | (1 << 4))
+
+// 报警录音（IMA-ADPCM 4:1，16kHz 下约 8 KB/s，见 AudioClip.h）
+#define AUDIO_CLIP_PRE_MS 1000       // 触发前保留时长 (ms)
+#define AUDIO_CLIP_POST_MS 1000      // 触发后继续录制时长 (ms)
+
+// ULP 睡眠监测（见 UlpSoundMonitor.h，逻辑可在主机端测试: pio test -e native-ulp）
+#define ULP_SOUND_PERIOD_MS 50       // ULP 运行周期 (ms)
+#define ULP_SOUND_BURST 16           // 每次运行连续采样点数
+#define ULP_SOUND_EMA_SHIFT 3        // 滑动平均系数 1/2^n
+#define ULP_SOUND_TRIGGER_COUNT 2    // 连续超阈值次数才唤醒
+#define ULP_SOUND_MARGIN_DB 6.0f     // ULP 阈值比噪音阈值低多少 (dB)，宁可多唤醒
+#define ULP_SOUND_MIN_ABOVE_FLOOR_DB 3.0f // ULP 阈值至少高出噪音基线 (dB)
+#define ULP_SOUND_FALSE_LIMIT 3      // 两次巡检之间误唤醒达到此次数后退避
+#define ULP_SOUND_HOLDOFF_SEC 1800   // 退避时长 (秒)，期间声音由定时巡检采样
 
 // ╔══════════════════════════════════════════════════════════════════╗
 // ║                    🔋 电池管理                                     ║
@@ -94,6 +196,21 @@
 #define BAT_VOLTAGE_DIV 2.0f    // 电池分压系数 (R16+R17)/R16
 #define ADC_REF_VOLTAGE 3.3f    // ESP32 ADC 参考电压
 
+// 电流模型（能耗账本估算用，按实测值修改）
+#define BAT_CAPACITY_MAH 3000.0f      // 电池容量 (mAh)
+#define CURRENT_CPU_ACTIVE_MA 45.0f   // CPU 运行（无射频）
+#define CURRENT_WIFI_TX_MA 130.0f     // WiFi 关联/收发（在 CPU 之上额外）
+#define CURRENT_CAMERA_MA 80.0f       // 相机工作（额外）
+#define CURRENT_GPS_ACQ_MA 25.0f      // GPS 搜星（额外）
+#define CURRENT_DEEP_SLEEP_UA 150.0f  // 深度睡眠（含 IMU 待机）
+#define CURRENT_STATIC_LEAK_MA 1.0f   // 电池分压电阻持续漏电 (R16+R17)
+#define ENERGY_HISTORY_DAYS 7         // RTC 中保留的日耗电量天数
+
+// 分阶段电源策略 (ENABLE_POWER_MANAGEMENT)
+#define PM_MAX_FREQ_MHZ 240   // HTTP/TLS、相机阶段
+#define PM_MIN_FREQ_MHZ 80    // 其余阶段（WiFi 要求不低于 80MHz）
+#define PM_AUTO_LIGHT_SLEEP 1 // 空闲时自动 Light-sleep（串口日志可能被截断）
+
 // ╔══════════════════════════════════════════════════════════════════╗
 // ║                    💤 休眠策略                                     ║
 // ╚══════════════════════════════════════════════════════════════════╝
@@ -108,6 +225,39 @@
 #define TEST_LOOP_DELAY_SEC 10      // 测试模式循环延迟 (秒)
 #endif
 
+// 心跳批量模式 (ENABLE_HEARTBEAT_BATCH)
+#if USE_MOCK_HARDWARE
+#define HB_SAMPLE_INTERVAL_SEC 5    // Wokwi 测试: 每 5 秒采样一次
+#else
+#define HB_SAMPLE_INTERVAL_SEC 600  // 采样间隔: 10 分钟 (×HB_BATCH_SIZE ≈ 原心跳间隔)
+#endif
+#define HB_BATCH_SIZE 6             // 每累计 K 个样本联网上报一次
+#define HB_BATCH_CAPACITY 32        // RTC 缓冲容量（上传失败时保留的最大样本数）
+
+// 常规巡检唤醒间隔：批量模式下按采样间隔唤醒
+#if ENABLE_HEARTBEAT_BATCH
+#define PATROL_INTERVAL_SEC HB_SAMPLE_INTERVAL_SEC
+#else
+#define PATROL_INTERVAL_SEC HEARTBEAT_INTERVAL_SEC
+#endif
+
+// 变化驱动上报 (ENABLE_DELTA_REPORT)：死区内的读数视为未变化
+#define DELTA_ANGLE_DEADBAND 0.5f     // 倾角死区 (°)
+#define DELTA_DB_DEADBAND 6.0f        // 分贝死区 (dB)
+#define DELTA_VOLTAGE_DEADBAND 0.05f  // 电压死区 (V)
+#if USE_MOCK_HARDWARE
+#define DELTA_MAX_SILENCE_SEC 60      // Wokwi 测试: 最长静默 1 分钟
+#else
+#define DELTA_MAX_SILENCE_SEC 21600   // 最长静默 6 小时，到期无变化也上报
+#endif
+
+// ╔══════════════════════════════════════════════════════════════════╗
+// ║                    📊 唤醒周期性能剖析                              ║
+// ╚══════════════════════════════════════════════════════════════════╝
+#define PROFILER_RING_SIZE 8      // RTC 中保留的周期记录数
+#define PROFILER_REPORT_CYCLES 4  // 心跳中汇总的最近周期数
+#define FAST_BOOT_SERIAL_WAIT_MS 0 // 快速启动：等待串口监视器的时间 (ms)，调试时可调大
+
 // ╔══════════════════════════════════════════════════════════════════╗
 // ║                    🌐 HTTP API 配置                                ║
 // ╚══════════════════════════════════════════════════════════════════╝
@@ -120,10 +270,21 @@
 #define HTTP_API_ALARM "/api/alarm"        // 报警上报接口
 #define HTTP_API_STATUS "/api/status"      // 状态心跳接口
 #define HTTP_API_IMAGE "/api/upload/image" // 图片上传接口
+#define HTTP_API_AUDIO "/api/upload/audio" // 录音上传接口
 
 // 设备标识
 #define HTTP_DEVICE_ID "POLE_001" // 设备唯一 ID
 
+// ╔══════════════════════════════════════════════════════════════════╗
+// ║                    📦 断网缓存队列 (LittleFS)                      ║
+// ╚══════════════════════════════════════════════════════════════════╝
+#define TQ_LOG_PATH "/tq.log"           // 记录文件（每行一条 JSON）
+#define TQ_OFFSET_PATH "/tq.off"        // 已发送偏移
+#define TQ_TMP_PATH "/tq.tmp"           // 压缩用临时文件
+#define TQ_MAX_BYTES (256 * 1024)       // 队列上限，超出后丢弃最旧记录
+#define TQ_BATCH_MAX_BYTES 1500         // 单批上限 (GET 传参需 URL 编码，勿过大)
+#define TQ_MAX_BATCHES_PER_SESSION 8    // 单次联网最多补发批数
+
 // ╔══════════════════════════════════════════════════════════════════╗
 // ║                    ⏱️ 通信超时                                     ║
 // ╚══════════════════════════════════════════════════════════════════╝
@@ -131,3 +292,32 @@
 #define HTTP_RESPONSE_TIMEOUT_SEC 60     // HTTP 响应超时 (秒)
 #define HTTP_DATA_TIMEOUT_SEC 80         // HTTP 数据传输超时 (秒)
 #define HTTP_IMAGE_TIMEOUT_SEC 120       // HTTP 图片上传超时 (秒)
+
+// ╔══════════════════════════════════════════════════════════════════╗
+// ║                    🚨 报警流水线 (GPS/网络/相机并行)                ║
+// ╚══════════════════════════════════════════════════════════════════╝
+// 截止时间均相对报警开始时刻计算
+#if USE_MOCK_HARDWARE
+#define ALARM_GPS_DEADLINE_MS 5000     // GPS 定位截止 (ms)
+#else
+#define ALARM_GPS_DEADLINE_MS 30000    // GPS 定位截止 (ms)
+#endif
+#define ALARM_CAMERA_DEADLINE_MS 8000  // 照片就绪截止 (ms)，超时则不上传图片
+#define ALARM_PIPELINE_JOIN_TIMEOUT_MS (ALARM_GPS_DEADLINE_MS + 5000) // 任务汇合上限
+#define ALARM_GPS_SLICE_MS 1000        // GPS 分段搜星，每段结束检查网络是否已失败
+#define ALARM_OFFLINE_JOIN_TIMEOUT_MS (ALARM_GPS_SLICE_MS + 2000) // 网络失败后的汇合上限 (ms)
+#define ALARM_TASK_STACK_SIZE 6144     // GPS/相机任务栈大小 (bytes)，相机任务含 JPEG 编解码
+
+// ╔══════════════════════════════════════════════════════════════════╗
+// ║                    🔁 唤醒状态机 (各状态时间预算)                   ║
+// ╚══════════════════════════════════════════════════════════════════╝
+// 超出预算只记录次数；唤醒窗口超过 SM_WAKE_BUDGET_MS 时跳过心跳上报
+#define SM_BUDGET_INIT_MS 50
+#define SM_BUDGET_BATTERY_MS 150      // 10 次采样 × 5ms + 余量
+#define SM_BUDGET_SENSORS_MS (1500 + AUDIO_CLIP_POST_MS) // 倾角 + 声音采样 + 报警录音
+#define SM_BUDGET_EVALUATE_MS 50
+#define SM_BUDGET_ALARM_MS (NETWORK_CONNECT_TIMEOUT_MS + ALARM_PIPELINE_JOIN_TIMEOUT_MS)
+#define SM_BUDGET_REPORT_MS (NETWORK_CONNECT_TIMEOUT_MS + 10000)
+#define SM_BUDGET_SLEEP_MS 200
+#define SM_WAKE_BUDGET_MS 10000       // 进入可跳过状态前的唤醒窗口上限
+#define SM_MAX_RESUME_ATTEMPTS 2      // 中断的报警最多恢复次数
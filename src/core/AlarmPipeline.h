@@ -0,0 +1,433 @@
+#pragma once
+
+/**
+ * @file AlarmPipeline.h
+ * @brief 并发报警流水线 - GPS 定位 / 网络连接 / 摄像头预热三路并行
+ *
+ * 时序（原流程为三段串行，最坏 45s+ 才发出第一个字节）:
+ *
+ *   t0 ──┬── [GPS 任务]  init → getLocation(ALARM_GPS_DEADLINE_MS)
+ *        ├── [相机任务]  init → capturePhoto
+ *        └── [调用者]    init → connectNetwork
+ *
+ *   网络就绪 → 立即发送报警 JSON（GPS 已就绪则附带坐标）
+ *            → 在 ALARM_CAMERA_DEADLINE_MS 内等待照片 → 上传
+ *              （ENABLE_IMAGE_TIERS: 只传缩略图，原图缓存待服务器请求，见 ImageCache）
+ *              （ENABLE_SCENE_CHANGE: 画面与上次上传相比未变化时跳过或只传缩略图，见 SceneChange）
+ *            → 噪音报警附带录音片段（AudioClip）→ 上传
+ *            → GPS 迟到 → 以 LOCATION 补充消息发送坐标
+ *            → 补发断网缓存队列中的积压记录
+ *   报警 JSON 发送失败 → 写入断网缓存队列，若本次补发积压成功则视为已送达
+ *   网络失败 → 报警 JSON 写入断网缓存队列（TelemetryQueue）
+ *            → 置 EVT_NET_FAILED：GPS 停止搜星、相机未拍照则不再拍，
+ *              汇合等待缩短为 ALARM_OFFLINE_JOIN_TIMEOUT_MS
+ *
+ * 生命周期:
+ *   - 上下文在堆上分配，由调用者与两个任务共享
+ *   - 返回前等待两个任务结束（上限 ALARM_PIPELINE_JOIN_TIMEOUT_MS，网络失败时
+ *     ALARM_OFFLINE_JOIN_TIMEOUT_MS）
+ *   - 若任务仍未结束，宁可泄漏上下文也不释放（随后即深度睡眠）
+ */
+
+#include "../../include/AppConfig.h"
+#include "../interfaces/ICamera.h"
+#include "../interfaces/IComm.h"
+#include "../interfaces/IGPS.h"
+#include "../utils/AudioClip.h"
+#include "../utils/DataPayload.h"
+#include "../utils/ImageCache.h"
+#include "../utils/SceneChange.h"
+#include "../utils/TelemetryQueue.h"
+#include "../utils/TiltTrend.h"
+#include "../utils/WakeProfiler.h"
+#include "DeviceFactory.h"
+#include "SystemManager.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+
+class AlarmPipeline {
+private:
+  // 事件位
+  static const EventBits_t EVT_GPS_DONE = (1 << 0);    // GPS 任务结束（成功或超时）
+  static const EventBits_t EVT_CAMERA_DONE = (1 << 1); // 相机任务结束（成功或失败）
+  static const EventBits_t EVT_NET_FAILED = (1 << 2);  // 网络连接失败，任务应尽快结束
+
+  /**
+   * @brief 调用者与任务共享的上下文
+   */
+  struct Context {
+    EventGroupHandle_t events = nullptr;
+
+    // GPS 阶段输出
+    GpsData gpsData;
+    bool hasGps = false;
+
+    // 相机阶段输入：照片字节预算（按电量）
+    size_t photoBudget = CAM_JPEG_BUDGET_BYTES;
+
+    // 相机阶段输出（帧缓冲归相机所有，由调用者释放）
+    ICamera *camera = nullptr;
+    uint8_t *photoBuffer = nullptr;
+    size_t photoSize = 0;
+    int photoQuality = 0;
+    bool hasPhoto = false;
+    bool sceneChanged = true; // 与参考图相比画面已变（或无法判断）
+
+    // 两级上传：缩略图（fmt2jpg 分配，调用者 free）与原图缓存 id
+    uint8_t *thumbBuffer = nullptr;
+    size_t thumbSize = 0;
+    uint32_t imageId = 0;
+  };
+
+public:
+  /**
+   * @brief 执行一次完整报警
+   * @param type  报警类型 ("tilt" / "noise" / "creep")
+   * @param value 倾角(°) 或 分贝(dB)
+   * @param voltage 电池电压
+   * @param label 声音分类标签（仅噪音报警，可为 nullptr）
+   * @return true=报警 JSON 已送达（直接发送，或写入队列后随本次补发送达）
+   */
+  static bool run(const char *type, float value, float voltage,
+                  const char *label = nullptr) {
+    Context *ctx = new Context();
+    ctx->events = xEventGroupCreate();
+    if (ctx->events == nullptr) {
+      DEBUG_PRINTLN("[流水线] ❌ 事件组创建失败");
+      delete ctx;
+      return false;
+    }
+
+    uint32_t t0 = millis();
+    ctx->photoBudget = photoBudgetFor(voltage);
+
+    // 1. 启动并行阶段
+    startGpsStage(ctx);
+    startCameraStage(ctx);
+
+    // 2. 调用者任务负责网络连接
+    IComm *commModule = DeviceFactory::createCommModule();
+    bool online = false;
+    {
+      ProfileSpan span(PHASE_WIFI);
+      online = commModule && commModule->init() && commModule->connectNetwork();
+    }
+    DEBUG_PRINTF("[流水线] 网络%s (+%lu ms)\n", online ? "就绪" : "失败",
+                 millis() - t0);
+
+    bool isNoise = strcmp(type, "noise") == 0;
+    bool success = false;
+    if (online) {
+      // 3. 网络就绪即发送报警，GPS 已就绪则附带
+      bool gpsAttached = (xEventGroupGetBits(ctx->events) & EVT_GPS_DONE) && ctx->hasGps;
+      String alarmJson = buildAlarmJson(type, value, voltage, label,
+                                        gpsAttached ? &ctx->gpsData : nullptr);
+      char alarmResponse[256] = {0};
+      success = sendAlarmJson(commModule, type, alarmJson, alarmResponse, sizeof(alarmResponse));
+      DEBUG_PRINTF("[流水线] 报警已发出 (+%lu ms)\n", millis() - t0);
+      bool queued = false; // 报警已写入断网队列，待步骤 6 补发
+#if ENABLE_TELEMETRY_QUEUE
+      if (!success) {
+        queued = TelemetryQueue::push(alarmJson.c_str());
+      }
+#endif
+
+      // 4. 照片作为后续消息
+      if (waitFor(ctx, EVT_CAMERA_DONE, t0, ALARM_CAMERA_DEADLINE_MS) &&
+          ctx->hasPhoto) {
+        if (!ctx->sceneChanged && SCENE_UNCHANGED_SKIP) {
+          DEBUG_PRINTLN("[流水线] 画面未变化，跳过照片上传");
+        } else if (ctx->thumbBuffer && (ctx->imageId || !ctx->sceneChanged)) {
+          if (uploadThumbnail(commModule, type, ctx)) {
+            SceneChange::commitReference();
+          }
+          if (ctx->imageId) {
+            ImageCache::handleDownlink(commModule, alarmResponse);
+          }
+        } else if (uploadPhoto(commModule, type, ctx)) {
+          SceneChange::commitReference();
+        }
+      } else {
+        DEBUG_PRINTLN("[流水线] ⚠️ 照片未在截止时间内就绪");
+      }
+      if (isNoise && AudioClip::isReady()) {
+        uploadAudioClip(commModule, type);
+      }
+
+      // 5. GPS 迟到则补发定位
+      if (!gpsAttached &&
+          waitFor(ctx, EVT_GPS_DONE, t0, ALARM_GPS_DEADLINE_MS) && ctx->hasGps) {
+        sendLocationFollowUp(commModule, type, ctx->gpsData);
+      }
+
+#if ENABLE_TELEMETRY_QUEUE
+      // 6. 借本次联网补发积压
+      {
+        ProfileSpan span(PHASE_HTTP);
+        if (TelemetryQueue::drain(commModule) && queued) {
+          // 报警已随积压送达：视为已发送，避免调用者再走其他报警/心跳把同一会话的数据重发
+          DEBUG_PRINTLN("[流水线] ✓ 报警已随积压补发");
+          success = true;
+        }
+      }
+#endif
+    } else {
+      DEBUG_PRINTLN("[通信] ❌ 连接失败");
+      xEventGroupSetBits(ctx->events, EVT_NET_FAILED);
+#if ENABLE_TELEMETRY_QUEUE
+      bool gpsReady = (xEventGroupGetBits(ctx->events) & EVT_GPS_DONE) && ctx->hasGps;
+      TelemetryQueue::push(
+          buildAlarmJson(type, value, voltage, label, gpsReady ? &ctx->gpsData : nullptr)
+              .c_str());
+#endif
+    }
+
+    // 7. 汇合并清理（录音属于噪音报警，倾斜报警先行时保留给其后的噪音报警）
+    if (isNoise) {
+      AudioClip::release();
+    }
+    uint32_t joinDeadline = online ? ALARM_PIPELINE_JOIN_TIMEOUT_MS
+                                   : (millis() - t0) + ALARM_OFFLINE_JOIN_TIMEOUT_MS;
+    bool joined = waitFor(ctx, EVT_GPS_DONE | EVT_CAMERA_DONE, t0, joinDeadline);
+    bool cameraDone = xEventGroupGetBits(ctx->events) & EVT_CAMERA_DONE;
+    if (cameraDone && ctx->thumbBuffer) {
+      free(ctx->thumbBuffer);
+    }
+    if (cameraDone) {
+      SceneChange::discardReference(); // 未上传成功的画面不作为参考
+    }
+    if (cameraDone && ctx->camera) {
+      ctx->camera->releasePhoto();
+      ctx->camera->powerOff();
+      DeviceFactory::destroy(ctx->camera);
+    }
+
+    if (commModule) {
+      commModule->sleep();
+    }
+    DeviceFactory::destroy(commModule);
+
+    if (joined) {
+      vEventGroupDelete(ctx->events);
+      delete ctx;
+    } else {
+      DEBUG_PRINTLN("[流水线] ⚠️ 任务未按时结束，保留上下文");
+    }
+
+    DEBUG_PRINTF("[流水线] 完成 (总耗时 %lu ms)\n", millis() - t0);
+    return success;
+  }
+
+private:
+  /**
+   * @brief 等待事件位，截止时间相对流水线起点 t0 计算
+   * @return true=所有位均已置位
+   */
+  static bool waitFor(Context *ctx, EventBits_t bits, uint32_t t0,
+                      uint32_t deadlineMs) {
+    uint32_t elapsed = millis() - t0;
+    TickType_t ticks = (elapsed >= deadlineMs) ? 0 : pdMS_TO_TICKS(deadlineMs - elapsed);
+    EventBits_t got = xEventGroupWaitBits(ctx->events, bits, pdFALSE, pdTRUE, ticks);
+    return (got & bits) == bits;
+  }
+
+  static bool netFailed(Context *ctx) {
+    return xEventGroupGetBits(ctx->events) & EVT_NET_FAILED;
+  }
+
+  // ==========================================
+  // 并行阶段
+  // ==========================================
+
+  static void startGpsStage(Context *ctx) {
+#if !ENABLE_GPS
+    xEventGroupSetBits(ctx->events, EVT_GPS_DONE); // GPS 已禁用
+#else
+    if (xTaskCreatePinnedToCore(gpsTask, "alarm_gps", ALARM_TASK_STACK_SIZE, ctx,
+                                1, nullptr, tskNO_AFFINITY) != pdPASS) {
+      DEBUG_PRINTLN("[流水线] ⚠️ GPS 任务创建失败");
+      xEventGroupSetBits(ctx->events, EVT_GPS_DONE);
+    }
+#endif
+  }
+
+  static void startCameraStage(Context *ctx) {
+#if !ENABLE_CAMERA
+    xEventGroupSetBits(ctx->events, EVT_CAMERA_DONE); // 相机已禁用
+#else
+    if (xTaskCreatePinnedToCore(cameraTask, "alarm_cam", ALARM_TASK_STACK_SIZE, ctx,
+                                1, nullptr, tskNO_AFFINITY) != pdPASS) {
+      DEBUG_PRINTLN("[流水线] ⚠️ 相机任务创建失败");
+      xEventGroupSetBits(ctx->events, EVT_CAMERA_DONE);
+    }
+#endif
+  }
+
+  static void gpsTask(void *arg) {
+    Context *ctx = static_cast<Context *>(arg);
+
+    {
+      ProfileSpan span(PHASE_GPS);
+      IGPS *gps = DeviceFactory::createGpsModule();
+      if (gps && gps->init()) {
+        // 分段搜星：网络失败后坐标已无处可发，尽早断电
+        uint32_t start = millis();
+        while (!ctx->hasGps && !netFailed(ctx) &&
+               millis() - start < ALARM_GPS_DEADLINE_MS) {
+          uint32_t left = ALARM_GPS_DEADLINE_MS - (millis() - start);
+          ctx->hasGps = gps->getLocation(ctx->gpsData, min(left, (uint32_t)ALARM_GPS_SLICE_MS));
+        }
+        if (!ctx->hasGps) {
+          DEBUG_PRINTLN(netFailed(ctx) ? "[GPS] 网络失败，停止搜星" : "[GPS] ⚠️ 定位失败");
+        }
+        gps->sleep();
+      }
+      DeviceFactory::destroy(gps);
+    }
+
+    xEventGroupSetBits(ctx->events, EVT_GPS_DONE);
+    vTaskDelete(nullptr);
+  }
+
+  static void cameraTask(void *arg) {
+    Context *ctx = static_cast<Context *>(arg);
+
+    {
+      ProfileSpan span(PHASE_CAMERA);
+      ICamera *camera = DeviceFactory::createCamera();
+      ctx->camera = camera;
+      if (camera) {
+        camera->setByteBudget(ctx->photoBudget);
+      }
+      if (camera && !netFailed(ctx) && camera->init() && !netFailed(ctx)) {
+        ctx->hasPhoto = camera->capturePhoto(&ctx->photoBuffer, &ctx->photoSize);
+        ctx->photoQuality = camera->getJpegQuality();
+      }
+    }
+
+#if ENABLE_SCENE_CHANGE
+    if (ctx->hasPhoto) {
+      ctx->sceneChanged = SceneChange::check(ctx->photoBuffer, ctx->photoSize);
+    }
+#endif
+
+#if ENABLE_IMAGE_TIERS || ENABLE_SCENE_CHANGE
+    // 画面未变化时只要缩略图、不缓存原图；缩略图失败则退回上传原图
+    bool wantThumb = ctx->sceneChanged ? ENABLE_IMAGE_TIERS : !SCENE_UNCHANGED_SKIP;
+    if (ctx->hasPhoto && wantThumb &&
+        ImageCache::makeThumbnail(ctx->photoBuffer, ctx->photoSize, &ctx->thumbBuffer,
+                                  &ctx->thumbSize) &&
+        ENABLE_IMAGE_TIERS && ctx->sceneChanged) {
+      ctx->imageId = ImageCache::save(ctx->photoBuffer, ctx->photoSize);
+    }
+#endif
+
+    xEventGroupSetBits(ctx->events, EVT_CAMERA_DONE);
+    vTaskDelete(nullptr);
+  }
+
+  // ==========================================
+  // 上报
+  // ==========================================
+
+  static String buildAlarmJson(const char *type, float value, float voltage,
+                               const char *label, const GpsData *gps) {
+    String alarmJson;
+    if (strcmp(type, "tilt") == 0) {
+      if (gps) {
+        alarmJson = TiltAlarmPayload(value, voltage, gps->latitude, gps->longitude).toJson();
+      } else {
+        alarmJson = TiltAlarmPayload(value, voltage).toJson();
+      }
+    } else if (strcmp(type, "creep") == 0) {
+      float slope = TiltTrend::slopePerDay();
+      float days = TiltTrend::daysToThreshold();
+      alarmJson = gps ? CreepAlarmPayload(value, slope, days, voltage, gps->latitude,
+                                          gps->longitude)
+                            .toJson()
+                      : CreepAlarmPayload(value, slope, days, voltage).toJson();
+    } else {
+      // noise: value 是分贝值
+      NoiseAlarmPayload payload =
+          gps ? NoiseAlarmPayload(voltage, value, gps->latitude, gps->longitude)
+              : NoiseAlarmPayload(voltage, value);
+      payload.label = label;
+      alarmJson = payload.toJson();
+    }
+    return alarmJson;
+  }
+
+  static bool sendAlarmJson(IComm *commModule, const char *type,
+                            const String &alarmJson, char *serverResponse,
+                            size_t maxResponseLen) {
+    DEBUG_PRINTF("[上报] 📤 %s报警: %s\n",
+                 strcmp(type, "tilt") == 0    ? "倾斜"
+                 : strcmp(type, "creep") == 0 ? "蠕变"
+                                              : "噪音",
+                 alarmJson.c_str());
+
+    ProfileSpan span(PHASE_HTTP);
+    bool success = commModule->sendAlarm(alarmJson.c_str(), serverResponse, maxResponseLen);
+    if (success) {
+      DEBUG_PRINTLN("[上报] ✓ 发送成功");
+    }
+    return success;
+  }
+
+  /**
+   * @brief 照片字节预算：低电量时收紧，缩短上传时的射频开启时间
+   */
+  static size_t photoBudgetFor(float voltage) {
+    return SystemManager::voltageToPercentage(voltage) < CAM_BUDGET_LOW_BAT_PCT
+               ? CAM_JPEG_BUDGET_LOW_BYTES
+               : CAM_JPEG_BUDGET_BYTES;
+  }
+
+  static bool uploadPhoto(IComm *commModule, const char *type, const Context *ctx) {
+    DEBUG_PRINTF("[上报] 📷 图片: %d bytes (质量 %d)\n", ctx->photoSize, ctx->photoQuality);
+    String metadata = String("{\"device_id\":\"") + HTTP_DEVICE_ID +
+                      "\",\"type\":\"" + type + "\",\"bytes\":" + ctx->photoSize +
+                      ",\"quality\":" + ctx->photoQuality + ",\"budget\":" + ctx->photoBudget + "}";
+    ProfileSpan span(PHASE_HTTP);
+    if (commModule->uploadImage(ctx->photoBuffer, ctx->photoSize, metadata.c_str())) {
+      DEBUG_PRINTLN("[上报] ✓ 图片上传成功");
+      return true;
+    }
+    DEBUG_PRINTLN("[上报] ⚠️ 图片上传失败");
+    return false;
+  }
+
+  static bool uploadThumbnail(IComm *commModule, const char *type, const Context *ctx) {
+    DEBUG_PRINTF("[上报] 📷 缩略图 #%lu: %d bytes（原图 %d bytes %s）\n",
+                 (unsigned long)ctx->imageId, ctx->thumbSize, ctx->photoSize,
+                 ctx->imageId ? "已缓存" : "画面未变化，未缓存");
+    ProfileSpan span(PHASE_HTTP);
+    if (ImageCache::uploadThumbnail(commModule, type, ctx->imageId, ctx->thumbBuffer,
+                                    ctx->thumbSize, ctx->photoSize, ctx->photoQuality)) {
+      DEBUG_PRINTLN("[上报] ✓ 缩略图上传成功");
+      return true;
+    }
+    DEBUG_PRINTLN("[上报] ⚠️ 缩略图上传失败");
+    return false;
+  }
+
+  static void uploadAudioClip(IComm *commModule, const char *type) {
+    DEBUG_PRINTF("[上报] 🎙️ 录音: %d bytes\n", AudioClip::size());
+    String metadata = AudioClip::metadataJson(type);
+    ProfileSpan span(PHASE_HTTP);
+    if (commModule->uploadAudio(AudioClip::data(), AudioClip::size(), metadata.c_str())) {
+      DEBUG_PRINTLN("[上报] ✓ 录音上传成功");
+    } else {
+      DEBUG_PRINTLN("[上报] ⚠️ 录音上传失败");
+    }
+  }
+
+  static void sendLocationFollowUp(IComm *commModule, const char *type,
+                                   const GpsData &gps) {
+    String json = LocationPayload(type, gps.latitude, gps.longitude).toJson();
+    DEBUG_PRINTF("[上报] 📤 补充定位: %s\n", json.c_str());
+    ProfileSpan span(PHASE_HTTP);
+    commModule->sendAlarm(json.c_str());
+  }
+};
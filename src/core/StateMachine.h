@@ -0,0 +1,290 @@
+#pragma once
+
+/**
+ * @file StateMachine.h
+ * @brief 表驱动唤醒状态机 - 以 SystemState 为状态，按状态表分发处理函数
+ *
+ * 状态表每项 = 处理函数 + 时间预算；处理函数返回下一状态（流程见 WorkflowManager）:
+ *
+ *   INIT → CHECK_BATTERY → READ_SENSORS → EVALUATE ─┬→ ALARM ─┬→ SLEEP
+ *                               │                   ├→ REPORT ┘
+ *                               └→ ERROR → SLEEP    └→ SLEEP（无事发生/批量未满）
+ *
+ * 设计说明:
+ *   - 当前状态写入 RTC 内存（定义于 main.cpp），进入 SLEEP 即视为周期正常结束
+ *   - 进入 ALARM 时报警参数写入 RTC_NOINIT 记录（magic + CRC 校验）。RTC_DATA_ATTR
+ *     变量在深度睡眠唤醒以外的每次复位都会被引导程序从 flash 重新初始化，
+ *     RTC_NOINIT_ATTR 则不会。若周期在 ALARM 中被看门狗/panic/软件重启打断，
+ *     下次启动（esp_reset_reason() 为上述原因时）直接从 ALARM 恢复，
+ *     最多 SM_MAX_RESUME_ATTEMPTS 次。上电/掉电复位时记录内容不可信，一律丢弃
+ *   - 单个状态超出预算只记录；唤醒窗口已超过 SM_WAKE_BUDGET_MS 时，
+ *     标记为可跳过的状态（如 REPORT）直接转入 SLEEP
+ *   - 每次状态切换调用转换钩子（默认记入 WakeProfiler 并打印耗时，可替换）
+ */
+
+#include "../../include/AppConfig.h"
+#include "../utils/WakeProfiler.h"
+#include "SystemManager.h"
+#include <esp_rom_crc.h>
+#include <esp_sleep.h>
+#include <esp_system.h>
+#include <stddef.h>
+
+/**
+ * @brief 单次唤醒在各状态间传递的数据
+ */
+struct WakeContext {
+  esp_sleep_wakeup_cause_t cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+  float batteryVoltage = 0.0f;
+  float tiltAngle = 0.0f;
+  float soundDb = 30.0f;
+  bool noiseDetected = false;
+  uint8_t soundClass = 0;                    // SoundClass（噪音超标时才分类）
+  bool tiltAlarm = false;
+  bool noiseAlarm = false;
+  bool creepAlarm = false;                   // 缓慢蠕变趋势报警（见 TiltTrend.h）
+  bool resumed = false;                      // 从中断的 ALARM 恢复
+  uint32_t sleepSec = PATROL_INTERVAL_SEC;   // SLEEP 状态使用的睡眠时长
+};
+
+typedef SystemState (*StateHandler)(WakeContext &ctx);
+typedef void (*TransitionHook)(SystemState from, SystemState to, uint32_t elapsedMs);
+
+/**
+ * @brief 状态表项
+ */
+struct StateDef {
+  SystemState state;
+  StateHandler handler;
+  uint32_t budgetMs; // 0=不限
+  bool skippable;    // 唤醒窗口超预算时可跳过（直接 SLEEP）
+};
+
+/**
+ * @brief RTC 状态（定义于 main.cpp，RTC_DATA_ATTR：只跨越深度睡眠）
+ */
+struct StateMachineRtc {
+  uint32_t magic;
+  uint8_t current;                // 当前状态
+  uint16_t overruns[STATE_COUNT]; // 各状态超预算次数
+  uint16_t lastMs[STATE_COUNT];   // 各状态最近一次耗时 (ms)
+};
+
+/**
+ * @brief 待完成的报警（定义于 main.cpp，RTC_NOINIT_ATTR：跨越看门狗/panic/软件重启）
+ */
+struct PendingAlarmRecord {
+  uint32_t magic;
+  uint8_t resumeAttempts; // 已恢复次数
+  bool tiltAlarm;
+  bool noiseAlarm;
+  bool creepAlarm;
+  float tiltAngle;
+  float soundDb;
+  uint8_t soundClass;
+  float batteryVoltage;
+  float initialPitch; // 零点校准值同样位于 RTC_DATA，复位后随报警一并恢复
+  float initialRoll;
+  uint32_t crc; // 以上字段的 CRC32
+};
+
+class StateMachine {
+private:
+  static const uint32_t SM_MAGIC = 0x53544132;      // "STA2"（报警记录移出后递增）
+  static const uint32_t PENDING_MAGIC = 0x50414C4D; // "PALM"
+
+  static StateMachineRtc rtc;         // RTC 内存（定义于 main.cpp）
+  static PendingAlarmRecord pending;  // RTC_NOINIT 内存（定义于 main.cpp）
+  static TransitionHook hook;   // 转换钩子
+  static uint32_t wakeStartMs;  // 本次运行起点
+
+public:
+  /**
+   * @brief 替换转换钩子（nullptr=不调用）
+   */
+  static void setTransitionHook(TransitionHook h) { hook = h; }
+
+  /**
+   * @brief 上周期是否在 ALARM 中被打断且仍可恢复
+   */
+  static bool hasPendingAlarm() {
+    return pendingValid() && pending.resumeAttempts < SM_MAX_RESUME_ATTEMPTS;
+  }
+
+  /**
+   * @brief 本次运行已耗时 (ms)
+   */
+  static uint32_t elapsedMs() { return millis() - wakeStartMs; }
+
+  static uint16_t getOverruns(SystemState state) {
+    ensureState();
+    return state < STATE_COUNT ? rtc.overruns[state] : 0;
+  }
+
+  /**
+   * @brief 从 INIT（或中断的 ALARM）开始运行，直到 SLEEP 状态处理完毕
+   * @note 深度睡眠模式下 SLEEP 处理函数不会返回
+   */
+  static void run(const StateDef *table, size_t count, WakeContext &ctx) {
+    ensureState();
+    wakeStartMs = millis();
+
+    SystemState state = STATE_INIT;
+    if (restorePendingAlarm(ctx)) {
+      state = STATE_ALARM;
+    } else if (pendingValid()) {
+      DEBUG_PRINTLN("[状态机] ⚠️ 报警多次中断，放弃恢复");
+      clearPendingAlarm();
+    } else {
+      pending.magic = 0; // 上电后的随机内容或已失效的记录
+    }
+
+    while (true) {
+      const StateDef *def = find(table, count, state);
+      if (def == nullptr) {
+        LOG_E("状态机", "状态 %d 未定义", state);
+        def = find(table, count, STATE_ERROR);
+        if (def == nullptr) return;
+      }
+      state = def->state;
+
+      enter(state, ctx);
+      uint32_t t0 = millis();
+      SystemState next = def->handler(ctx);
+      uint32_t elapsed = millis() - t0;
+      record(def, elapsed);
+
+      if (state == STATE_SLEEP) return; // 仅非深度睡眠测试模式会走到这里
+
+      if (next != STATE_SLEEP && elapsedMs() > SM_WAKE_BUDGET_MS) {
+        const StateDef *nextDef = find(table, count, next);
+        if (nextDef && nextDef->skippable) {
+          DEBUG_PRINTF("[状态机] ⏱️ 唤醒窗口已用 %lu ms，跳过 %s\n",
+                       (unsigned long)elapsedMs(), stateName(next));
+          next = STATE_SLEEP;
+        }
+      }
+
+      if (hook) hook(state, next, elapsed);
+      state = next;
+    }
+  }
+
+  /**
+   * @brief 默认转换钩子：状态耗时记入 WakeProfiler，并打印状态切换
+   */
+  static void profileTransition(SystemState from, SystemState to, uint32_t elapsedMs) {
+    WakeProfiler::addState(from, elapsedMs);
+    logTransition(from, to, elapsedMs);
+  }
+
+  /**
+   * @brief 打印状态切换与耗时
+   */
+  static void logTransition(SystemState from, SystemState to, uint32_t elapsedMs) {
+    DEBUG_PRINTF("[状态机] %s → %s (%lu ms)\n", stateName(from), stateName(to),
+                 (unsigned long)elapsedMs);
+  }
+
+  static const char *stateName(SystemState state) {
+    static const char *const NAMES[STATE_COUNT] = {
+        "INIT", "CHECK_BATTERY", "READ_SENSORS", "EVALUATE",
+        "ALARM", "SLEEP", "ERROR", "REPORT"};
+    return state < STATE_COUNT ? NAMES[state] : "?";
+  }
+
+private:
+  static const StateDef *find(const StateDef *table, size_t count, SystemState state) {
+    for (size_t i = 0; i < count; i++) {
+      if (table[i].state == state) return &table[i];
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief 进入状态：写入 RTC；进入 ALARM 时保存报警记录，离开 ALARM 时清除
+   */
+  static void enter(SystemState state, const WakeContext &ctx) {
+    if (state == STATE_ALARM && !ctx.resumed) {
+      memset(&pending, 0, sizeof(pending));
+      pending.magic = PENDING_MAGIC;
+      pending.tiltAlarm = ctx.tiltAlarm;
+      pending.noiseAlarm = ctx.noiseAlarm;
+      pending.creepAlarm = ctx.creepAlarm;
+      pending.tiltAngle = ctx.tiltAngle;
+      pending.soundDb = ctx.soundDb;
+      pending.soundClass = ctx.soundClass;
+      pending.batteryVoltage = ctx.batteryVoltage;
+      pending.initialPitch = SystemManager::getInitialPitch();
+      pending.initialRoll = SystemManager::getInitialRoll();
+      sealPending();
+    } else if (state != STATE_ALARM && rtc.current == STATE_ALARM) {
+      clearPendingAlarm();
+    }
+    rtc.current = state;
+  }
+
+  static void record(const StateDef *def, uint32_t elapsed) {
+    rtc.lastMs[def->state] = (uint16_t)min(elapsed, (uint32_t)UINT16_MAX);
+    if (def->budgetMs && elapsed > def->budgetMs) {
+      if (rtc.overruns[def->state] < UINT16_MAX) rtc.overruns[def->state]++;
+      LOG_I("状态机", "%s 超出预算: %lu ms > %lu ms", stateName(def->state),
+            (unsigned long)elapsed, (unsigned long)def->budgetMs);
+    }
+  }
+
+  static bool restorePendingAlarm(WakeContext &ctx) {
+    if (!hasPendingAlarm()) return false;
+    pending.resumeAttempts++;
+    sealPending(); // 恢复过程中再次复位时计数不丢
+    ctx.tiltAlarm = pending.tiltAlarm;
+    ctx.noiseAlarm = pending.noiseAlarm;
+    ctx.creepAlarm = pending.creepAlarm;
+    ctx.tiltAngle = pending.tiltAngle;
+    ctx.soundDb = pending.soundDb;
+    ctx.soundClass = pending.soundClass;
+    ctx.batteryVoltage = pending.batteryVoltage;
+    ctx.resumed = true;
+    SystemManager::calibrateInitialPose(pending.initialPitch, pending.initialRoll);
+    DEBUG_PRINTF("[状态机] 恢复中断的报警 (第 %u 次)\n", pending.resumeAttempts);
+    return true;
+  }
+
+  static void clearPendingAlarm() { pending.magic = 0; }
+
+  static uint32_t pendingCrc() {
+    return esp_rom_crc32_le(0, (const uint8_t *)&pending, offsetof(PendingAlarmRecord, crc));
+  }
+
+  static void sealPending() { pending.crc = pendingCrc(); }
+
+  /**
+   * @brief 报警记录是否可信：复位原因为看门狗/panic/软件重启，且 magic、CRC 均通过
+   */
+  static bool pendingValid() {
+    switch (esp_reset_reason()) {
+    case ESP_RST_SW:
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+      break;
+    default:
+      return false;
+    }
+    return pending.magic == PENDING_MAGIC && pending.crc == pendingCrc() &&
+           (pending.tiltAlarm || pending.noiseAlarm || pending.creepAlarm);
+  }
+
+  static void ensureState() {
+    if (rtc.magic != SM_MAGIC || rtc.current >= STATE_COUNT) {
+      memset(&rtc, 0, sizeof(rtc));
+      rtc.magic = SM_MAGIC;
+      rtc.current = STATE_SLEEP;
+    }
+  }
+};
+
+// 静态成员初始化（rtc、pending 位于 RTC 内存，定义于 main.cpp）
+TransitionHook StateMachine::hook = StateMachine::profileTransition;
+uint32_t StateMachine::wakeStartMs = 0;
@@ -6,6 +6,13 @@
  */
 
 #include "../../include/AppConfig.h"
+#include "../utils/EnergyLedger.h"
+#include "../utils/NoiseFloor.h"
+#include "../utils/WakeHoldoff.h"
+#include "../utils/WakeProfiler.h"
+#include "UlpSoundMonitor.h"
+#include "WakeStub.h"
+#include <driver/rtc_io.h>
 #include <esp_sleep.h>
 
 // ==========================================
@@ -21,17 +28,6 @@ private:
   // 移除静态成员，改用上方的 RTC 全局变量
 
 public:
-  /**
-   * @brief 系统初始化
-   */
-  static void init() {
-    // 打印启动横幅
-    printBanner();
-
-    // 配置唤醒源
-    configureWakeupSources();
-  }
-
   /**
    * @brief 记录初始姿态（零点校准）
    */
@@ -70,23 +66,64 @@ public:
     return esp_sleep_get_wakeup_cause();
   }
 
+  /**
+   * @brief 装载声音与倾斜唤醒源（定时器在 deepSleep() 中设置）
+   * @note 每次入睡前调用：ULP 阈值随噪音基线变化，RTC 引脚配置也不跨越唤醒保持
+   */
+  static void armWakeupSources() {
+#if ULP_SOUND_ACTIVE
+    if (WakeHoldoff::isHeldOff(WAKE_SRC_SOUND)) {
+      DEBUG_PRINTLN("[SYS] 声音唤醒退避中，本次不启动 ULP");
+    } else if (!UlpSoundMonitor::arm(
+                   UlpSoundMonitor::tripDb(NoiseFloor::thresholdDb(), NoiseFloor::floorDb()))) {
+      DEBUG_PRINTLN("[SYS] ⚠️ ULP 装载失败，本次睡眠无声音唤醒");
+    }
+#elif !USE_MOCK_HARDWARE
+    // 注意: 模拟信号无法直接触发中断，需外接比较器输出到此引脚
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)PIN_MIC_ANALOG, HIGH);
+#endif
+
+#if ENABLE_TILT_INTERRUPT && !USE_MOCK_HARDWARE
+    if (WakeHoldoff::isHeldOff(WAKE_SRC_TILT)) {
+      DEBUG_PRINTLN("[SYS] 倾斜中断退避中，本次不装载 EXT1");
+    } else {
+      // IMU INT1 推挽输出、睡眠期间保持供电；下拉防止 IMU 掉电时引脚悬空误唤醒
+      rtc_gpio_pullup_dis((gpio_num_t)PIN_LSM_INT1);
+      rtc_gpio_pulldown_en((gpio_num_t)PIN_LSM_INT1);
+      esp_sleep_enable_ext1_wakeup(1ULL << PIN_LSM_INT1, ESP_EXT1_WAKEUP_ANY_HIGH);
+    }
+#endif
+  }
+
   /**
    * @brief 进入深度睡眠
    * @param seconds 睡眠时长（秒）
    */
   static void deepSleep(uint32_t seconds) {
+    {
+      ProfileSpan span(PHASE_SLEEP_ENTRY);
 #if DEBUG_SERIAL_ENABLE
-    Serial.flush();
+      Serial.flush();
 #endif
-    delay(100);
+      delay(100);
+    }
+    WakeProfiler::endCycle();
+    EnergyLedger::recordCycle(WakeProfiler::getCycle(0));
 
 #if ENABLE_DEEP_SLEEP
     DEBUG_PRINTF("[系统] 休眠 %d 秒...\n", seconds);
-    esp_sleep_enable_timer_wakeup(seconds * 1000000ULL);
+    uint32_t timerSec = seconds;
+#if WAKE_STUB_ACTIVE
+    timerSec = WakeStub::arm(seconds); // 期间由唤醒桩定期检查倾角
+#endif
+    armWakeupSources();
+    esp_sleep_enable_timer_wakeup(timerSec * 1000000ULL);
     esp_deep_sleep_start();
 #else
     // 测试模式：短延迟后继续
     delay(5000);
+    EnergyLedger::recordWake();
+    WakeProfiler::beginCycle();
 #endif
   }
 
@@ -107,6 +144,7 @@ public:
    * @note 分压电路持续漏电约 1mA，长期使用建议添加 GPIO 控制开关
    */
   static float readBatteryVoltage() {
+    ProfileSpan span(PHASE_BATTERY);
 #if USE_MOCK_HARDWARE
     g_mockVoltage -= 0.05f;
     if (g_mockVoltage < 3.3f)
@@ -141,8 +179,13 @@ public:
    *   3.4V = 0%   (低电量保护)
    */
   static int getBatteryPercentage() {
-    float voltage = readBatteryVoltage();
+    return voltageToPercentage(readBatteryVoltage());
+  }
 
+  /**
+   * @brief 电压换算电量百分比（不重新采样）
+   */
+  static int voltageToPercentage(float voltage) {
     // 满电保护
     if (voltage >= 4.2f)
       return 100;
@@ -190,6 +233,12 @@ public:
     case ESP_SLEEP_WAKEUP_EXT0:
       DEBUG_PRINTLN("GPIO 中断");
       break;
+    case ESP_SLEEP_WAKEUP_EXT1:
+      DEBUG_PRINTLN("IMU 倾斜中断");
+      break;
+    case ESP_SLEEP_WAKEUP_ULP:
+      DEBUG_PRINTF("ULP 声音 (峰峰值=%u)\n", UlpSoundMonitor::getLevel());
+      break;
     case ESP_SLEEP_WAKEUP_TIMER:
       DEBUG_PRINTLN("定时器");
       break;
@@ -199,39 +248,6 @@ public:
     }
 #endif
   }
-
-private:
-  /**
-   * @brief 配置唤醒源
-   */
-  static void configureWakeupSources() {
-// 1. 定时器唤醒（主要）
-// 在 deepSleep() 中动态设置
-
-// 2. GPIO 唤醒（声音传感器）
-#if !USE_MOCK_HARDWARE
-    // 注意: 模拟信号无法直接触发中断，此配置仅作为备用
-    // 如需声音中断唤醒，需外接比较器输出到此引脚
-    esp_sleep_enable_ext0_wakeup((gpio_num_t)PIN_MIC_ANALOG, HIGH);
-    DEBUG_PRINTLN("[SYS] 已启用 GPIO 唤醒源 (声音传感器)");
-#endif
-  }
-
-  /**
-   * @brief 打印启动横幅
-   */
-  static void printBanner() {
-    DEBUG_PRINTLN("\n");
-    DEBUG_PRINTLN("╔════════════════════════════════════════════╗");
-    DEBUG_PRINTLN("║   通信电缆杆监测系统 - Low Power Guardian  ║");
-    DEBUG_PRINTLN("╠════════════════════════════════════════════╣");
-    DEBUG_PRINTF("║   固件版本: %-27s ║\n", FIRMWARE_VERSION);
-    DEBUG_PRINTF("║   构建时间: %-27s ║\n", BUILD_DATE);
-    DEBUG_PRINTF("║   运行模式: %-27s ║\n",
-                 USE_MOCK_HARDWARE ? "Mock (开发)" : "Real (生产)");
-    DEBUG_PRINTLN("╚════════════════════════════════════════════╝");
-    DEBUG_PRINTLN("");
-  }
 };
 
 // 注意：不再需要静态成员初始化，因为已改用 RTC_DATA_ATTR 全局变量
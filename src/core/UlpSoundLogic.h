@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file UlpSoundLogic.h
+ * @brief ULP 声音监测的判定逻辑（C++ 镜像）- 供主机端模拟与单元测试
+ *
+ * 与 UlpSoundMonitor.h 中的 ULP-FSM 程序逐条对应，按 16 位寄存器语义实现
+ * （加减法回绕、右移截断），修改任一方时必须同步另一方:
+ *
+ *   if (enable == 0) halt
+ *   p2p   = max(burst) - min(burst)          // min 初值 4095，max 初值 0
+ *   acc   = acc - (acc >> shift) + p2p       // 指数滑动平均，稳态 acc = p2p << shift
+ *   level = acc >> shift
+ *   if (level > threshold) { hits++; if (hits >= trigger) wake }
+ *   else hits = 0
+ *
+ * 本文件只依赖 <stdint.h>，可在 Linux 上直接编译（见 test/test_ulp_sim）。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+// RTC_SLOW_MEM 中的变量布局（字地址，仅低 16 位有效），程序紧随其后
+#define ULP_VAR_ENABLE 0    // 主 CPU 写：1=监测 0=直接 halt（CPU 醒着时不占用 ADC1）
+#define ULP_VAR_THRESHOLD 1 // 主 CPU 写：唤醒阈值（峰峰值计数）
+#define ULP_VAR_ACC 2       // ULP 写：滑动平均累加器
+#define ULP_VAR_LEVEL 3     // ULP 写：当前声级（峰峰值计数）
+#define ULP_VAR_HITS 4      // ULP 写：连续超阈值次数
+#define ULP_DATA_WORDS 8    // 预留数据区大小（字）
+
+/**
+ * @brief ULP 数据区镜像
+ */
+struct UlpSoundState {
+  uint16_t enable = 0;
+  uint16_t threshold = 0;
+  uint16_t acc = 0;
+  uint16_t level = 0;
+  uint16_t hits = 0;
+};
+
+/**
+ * @brief 模拟一次 ULP 运行
+ * @param burst   本次连续采样（12 位）
+ * @param count   样本数（对应 ULP_SOUND_BURST）
+ * @param shift   滑动平均系数 (ULP_SOUND_EMA_SHIFT)
+ * @param trigger 连续超阈值多少次才唤醒 (ULP_SOUND_TRIGGER_COUNT)
+ * @return true=本次执行了 wake 指令
+ */
+inline bool ulpSoundStep(UlpSoundState &s, const uint16_t *burst, size_t count,
+                         uint8_t shift, uint16_t trigger) {
+  if (s.enable < 1) return false;
+
+  uint16_t minVal = 4095, maxVal = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (burst[i] < minVal) minVal = burst[i];
+    if (burst[i] > maxVal) maxVal = burst[i];
+  }
+  uint16_t p2p = (uint16_t)(maxVal - minVal);
+
+  s.acc = (uint16_t)(s.acc - (s.acc >> shift));
+  s.acc = (uint16_t)(s.acc + p2p);
+  s.level = (uint16_t)(s.acc >> shift);
+
+  if (s.level <= s.threshold) {
+    s.hits = 0;
+    return false;
+  }
+  s.hits = (uint16_t)(s.hits + 1);
+  return s.hits >= trigger;
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+/**
+ * @file UlpSoundMonitor.h
+ * @brief 深度睡眠期间的 ULP 声音监测 - 超阈值才唤醒主 CPU
+ *
+ * 原 ext0 唤醒接在麦克风模拟脚上，没有外部比较器时无法触发，睡眠期间的声音全部漏检。
+ * 改由 ULP 协处理器每 ULP_SOUND_PERIOD_MS 采集 ULP_SOUND_BURST 个 ADC1 样本，
+ * 维护滑动平均峰峰值，连续 ULP_SOUND_TRIGGER_COUNT 次超过阈值时唤醒主 CPU。
+ * 判定逻辑见 UlpSoundLogic.h（与下方程序逐条对应，可在主机端单元测试）。
+ *
+ * 设计说明:
+ *   - 使用 ULP-FSM，程序由 ulp.h 指令宏在运行时装载，无需单独的 ULP 工具链
+ *     （Arduino 构建不编译 RISC-V ULP 程序）
+ *   - 阈值由主 CPU 在入睡前写入（tripDb()）：噪音阈值 dB(A) 降低 ULP_SOUND_MARGIN_DB，
+ *     但不低于噪音基线 + ULP_SOUND_MIN_ABOVE_FLOOR_DB，再按正弦峰峰值换算为计数；
+ *     ULP 只负责"可能有声音"，唤醒后仍由主 CPU 做 Leq / 频谱分类的正式判定
+ *   - 连续误唤醒后由 WakeHoldoff 暂停 ULP 唤醒源，期间声音由定时巡检采样
+ *   - 主 CPU 醒着时 enable=0，ULP 定时运行但立即 halt，不与 DMA ADC 争用 ADC1
+ *   - 需要 sdkconfig 开启 CONFIG_ULP_COPROC_ENABLED 且预留内存足够；装载失败时本次睡眠
+ *     不设声音唤醒源（ext0 在无比较器时不可靠，不作退路）
+ */
+
+#include "../../include/AppConfig.h"
+#include "UlpSoundLogic.h"
+#include <esp_sleep.h>
+#include <math.h>
+
+#ifdef CONFIG_ULP_COPROC_ENABLED
+#define ULP_COPROC_AVAILABLE 1
+#else
+#define ULP_COPROC_AVAILABLE 0
+#endif
+
+#define ULP_SOUND_ACTIVE                                                       \
+  (ENABLE_ULP_SOUND && ENABLE_DEEP_SLEEP && !USE_MOCK_HARDWARE && ULP_COPROC_AVAILABLE)
+
+#if ULP_SOUND_ACTIVE
+#include "esp32s3/ulp.h"
+#include "esp_idf_version.h"
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include "ulp_adc.h"
+#else
+#include "driver/adc.h"
+#endif
+#endif
+
+class UlpSoundMonitor {
+public:
+  /**
+   * @brief ULP 触发声级 dB(A)：低于报警阈值留出余量，但始终高于噪音基线
+   * @param floorDb 噪音基线均值，未知时传 NAN
+   */
+  static float tripDb(float thresholdDb, float floorDb) {
+    float trip = thresholdDb - ULP_SOUND_MARGIN_DB;
+    if (!isnan(floorDb)) trip = max(trip, floorDb + ULP_SOUND_MIN_ABOVE_FLOOR_DB);
+    return trip;
+  }
+
+  /**
+   * @brief 触发声级 dB(A) → ULP 峰峰值阈值（计数）
+   */
+  static uint16_t thresholdFromDb(float tripDb) {
+    float rms = powf(10.0f, (tripDb - AUDIO_DBA_OFFSET) / 20.0f);
+    float p2p = rms * 2.828f;
+    return (uint16_t)constrain(p2p, 1.0f, 4095.0f);
+  }
+
+#if ULP_SOUND_ACTIVE
+  /**
+   * @brief 唤醒后立即调用：停止 ULP 采样，让出 ADC1
+   */
+  static void disarm() { RTC_SLOW_MEM[ULP_VAR_ENABLE] = 0; }
+
+  /**
+   * @brief 上次睡眠中 ULP 测得的声级（峰峰值计数）
+   */
+  static uint16_t getLevel() { return RTC_SLOW_MEM[ULP_VAR_LEVEL] & 0xFFFF; }
+
+  /**
+   * @brief 入睡前调用：装载程序、写入阈值、启动 ULP 并设为唤醒源
+   * @param tripDb 触发声级 dB(A)（见 tripDb()）
+   * @return false=装载失败，本次睡眠无声音唤醒
+   */
+  static bool arm(float tripDb) {
+    if (!configureAdc()) return false;
+
+    enum { L_SAMPLE, L_CHKMAX, L_NEWMIN, L_NEWMAX, L_NEXT, L_HIT, L_DONE };
+    const ulp_insn_t program[] = {
+        I_MOVI(R3, 0),
+        I_LD(R0, R3, ULP_VAR_ENABLE),
+        M_BL(L_DONE, 1),
+
+        // 连续采样，R1=最小值 R2=最大值，R3 作临时寄存器
+        I_MOVI(R1, 4095),
+        I_MOVI(R2, 0),
+        I_STAGERST(),
+        M_LABEL(L_SAMPLE),
+        I_ADC(R0, 0, AUDIO_ADC_CHANNEL), // [0]
+        I_SUBR(R3, R0, R1),              // [1] 样本 < 最小值 → 溢出
+        M_BXF(L_NEWMIN),                 // [2]
+        M_LABEL(L_CHKMAX),
+        I_SUBR(R3, R2, R0),              // [3] 最大值 < 样本 → 溢出
+        M_BXF(L_NEWMAX),                 // [4]
+        M_BX(L_NEXT),                    // [5]
+        M_LABEL(L_NEWMIN),
+        I_MOVR(R1, R0),                  // [6]
+        M_BX(L_CHKMAX),                  // [7]
+        M_LABEL(L_NEWMAX),
+        I_MOVR(R2, R0),                  // [8]
+        M_LABEL(L_NEXT),
+        I_STAGEINC(1),                           // [9]
+        I_JUMPS(-10, ULP_SOUND_BURST, JUMPS_LT), // [10] → [0]
+
+        // acc = acc - (acc >> shift) + p2p; level = acc >> shift
+        I_SUBR(R0, R2, R1),
+        I_MOVI(R3, 0),
+        I_LD(R1, R3, ULP_VAR_ACC),
+        I_RSHI(R2, R1, ULP_SOUND_EMA_SHIFT),
+        I_SUBR(R1, R1, R2),
+        I_ADDR(R1, R1, R0),
+        I_ST(R1, R3, ULP_VAR_ACC),
+        I_RSHI(R0, R1, ULP_SOUND_EMA_SHIFT),
+        I_ST(R0, R3, ULP_VAR_LEVEL),
+
+        // 阈值 < level → 溢出 → 计数
+        I_LD(R1, R3, ULP_VAR_THRESHOLD),
+        I_SUBR(R2, R1, R0),
+        M_BXF(L_HIT),
+        I_MOVI(R0, 0),
+        I_ST(R0, R3, ULP_VAR_HITS),
+        I_HALT(),
+
+        M_LABEL(L_HIT),
+        I_LD(R0, R3, ULP_VAR_HITS),
+        I_ADDI(R0, R0, 1),
+        I_ST(R0, R3, ULP_VAR_HITS),
+        M_BL(L_DONE, ULP_SOUND_TRIGGER_COUNT),
+        I_WAKE(),
+        M_LABEL(L_DONE),
+        I_HALT(),
+    };
+
+    size_t size = sizeof(program) / sizeof(ulp_insn_t);
+    esp_err_t err = ulp_process_macros_and_load(ULP_DATA_WORDS, program, &size);
+    if (err != ESP_OK) {
+      DEBUG_PRINTF("[ULP] ❌ 程序装载失败 (0x%x)\n", err);
+      return false;
+    }
+
+    uint16_t threshold = thresholdFromDb(tripDb);
+    RTC_SLOW_MEM[ULP_VAR_THRESHOLD] = threshold;
+    RTC_SLOW_MEM[ULP_VAR_ACC] = 0;
+    RTC_SLOW_MEM[ULP_VAR_LEVEL] = 0;
+    RTC_SLOW_MEM[ULP_VAR_HITS] = 0;
+    RTC_SLOW_MEM[ULP_VAR_ENABLE] = 1;
+
+    ulp_set_wakeup_period(0, ULP_SOUND_PERIOD_MS * 1000);
+    if (ulp_run(ULP_DATA_WORDS) != ESP_OK) {
+      RTC_SLOW_MEM[ULP_VAR_ENABLE] = 0;
+      return false;
+    }
+    esp_sleep_enable_ulp_wakeup();
+
+    DEBUG_PRINTF("[ULP] ✓ 声音监测: 每 %d ms 采 %d 点, 阈值 %u (%.0f dB)\n",
+                 ULP_SOUND_PERIOD_MS, ULP_SOUND_BURST, threshold, tripDb);
+    return true;
+  }
+
+private:
+  static bool configureAdc() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    ulp_adc_cfg_t cfg = {};
+    cfg.adc_n = ADC_UNIT_1;
+    cfg.channel = (adc_channel_t)AUDIO_ADC_CHANNEL;
+    cfg.width = ADC_BITWIDTH_12;
+    cfg.atten = ADC_ATTEN_DB_11;
+    cfg.ulp_mode = ADC_ULP_MODE_FSM;
+    return ulp_adc_init(&cfg) == ESP_OK;
+#else
+    return adc1_config_width(ADC_WIDTH_BIT_12) == ESP_OK &&
+           adc1_config_channel_atten((adc1_channel_t)AUDIO_ADC_CHANNEL, ADC_ATTEN_DB_11) ==
+               ESP_OK &&
+           adc1_ulp_enable() == ESP_OK;
+#endif
+  }
+#else
+  static void disarm() {}
+  static uint16_t getLevel() { return 0; }
+  static bool arm(float) { return false; }
+#endif
+};
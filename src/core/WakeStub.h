@@ -0,0 +1,356 @@
+#pragma once
+
+/**
+ * @file WakeStub.h
+ * @brief 深度睡眠唤醒桩 - 完整启动前先在 RTC 快速内存中检查倾角
+ *
+ * 时序（定时唤醒）:
+ *   ROM → esp_wake_deep_sleep() [RTC IRAM]
+ *          ├─ 软件 I2C 突发读取 LSM6DS3 加速度 (OUTX_L_XL 起 6 字节)
+ *          ├─ 与校准时的重力向量比较
+ *          ├─ 倾角在阈值内且未到巡检时刻 → 重设定时器，直接回到深度睡眠（数毫秒）
+ *          └─ 否则返回 → 继续完整启动（Arduino → setup() → 状态机）
+ *
+ * 设计说明:
+ *   - deepSleep(seconds) 改为每 WAKE_STUB_INTERVAL_SEC 唤醒一次，由唤醒桩检查倾角，
+ *     累计到 seconds 才完整启动：巡检/上报节奏不变，倾斜发现更早
+ *   - 判定用校准重力向量 r 与当前向量 a 的夹角 θ：a·r > 0 且 |a×r|² ≤ sin²θ·|a|²·|r|²
+ *     俯仰角、横滚角的变化都不会超过 θ，因此唤醒桩判定"未倾斜"时完整流程也不会报警
+ *   - 唤醒桩只能执行 RTC IRAM 中的代码和 ROM 函数：不用浮点、除法、switch 跳转表
+ *     和 Arduino API；定时器节拍数与阈值在进入睡眠前由主程序换算好
+ *   - 寄存器按 ESP32-S3 编写；Mock 模式或未启用深度睡眠时整个文件为空
+ */
+
+#include "../../include/AppConfig.h"
+
+#define WAKE_STUB_ACTIVE (ENABLE_WAKE_STUB && ENABLE_DEEP_SLEEP && !USE_MOCK_HARDWARE)
+
+#if WAKE_STUB_ACTIVE
+
+#include "esp_attr.h"
+#include "esp_rom_sys.h"
+#include "esp_sleep.h"
+#include "soc/gpio_reg.h"
+#include "soc/gpio_sig_map.h"
+#include "soc/io_mux_reg.h"
+#include "soc/rtc.h"
+#include "soc/rtc_cntl_reg.h"
+
+#define LSM6DS3_OUTX_L_XL 0x28 // 加速度 X/Y/Z 低字节起始（地址自动递增）
+
+/**
+ * @brief 唤醒桩最近一次的判定结果（诊断用）
+ */
+enum WakeStubResult : uint8_t {
+  WAKE_STUB_NONE = 0,
+  WAKE_STUB_SLEPT,    // 倾角正常，直接回睡
+  WAKE_STUB_DUE,      // 巡检时刻已到
+  WAKE_STUB_TILTED,   // 超出阈值
+  WAKE_STUB_I2C_FAIL, // IMU 无应答
+  WAKE_STUB_OTHER_SRC // 非定时器唤醒
+};
+
+/**
+ * @brief 唤醒桩状态（RTC 慢速内存，唤醒桩与主程序共享）
+ */
+struct WakeStubState {
+  uint32_t magic;
+  bool calibrated;        // 已记录参考向量
+  bool armed;             // 本次睡眠由唤醒桩接管
+  uint8_t i2cAddr;        // IMU 地址
+  uint8_t lastResult;     // WakeStubResult
+  int32_t ref[3];         // 校准重力向量（原始值 >> 2）
+  int32_t sinSqLimit;     // sin²θ·|r|²
+  uint16_t skipsLeft;     // 还可直接回睡的次数
+  uint16_t skipped;       // 本轮已直接回睡的次数
+  uint64_t intervalTicks; // 单次检查间隔（RTC 慢时钟节拍）
+};
+
+// [关键] 唤醒桩只能访问 RTC 内存，因此定义为 RTC 全局变量
+RTC_DATA_ATTR WakeStubState g_wakeStub;
+
+static const uint32_t WAKE_STUB_MAGIC = 0x53545542; // "STUB"
+
+// IO_MUX 寄存器按引脚号拼接（需先展开 PinMap 中的宏）
+#define WS_IOMUX_REG(pin) WS_IOMUX_REG_(pin)
+#define WS_IOMUX_REG_(pin) IO_MUX_GPIO##pin##_REG
+
+// ==========================================
+// 唤醒桩代码（RTC IRAM）
+// 软件 I2C：输出电平恒为低，通过输出使能模拟开漏，释放时靠上拉拉高
+// ==========================================
+
+static inline void RTC_IRAM_ATTR wsLow(uint32_t pin) {
+  REG_WRITE(GPIO_ENABLE_W1TS_REG, BIT(pin));
+}
+
+static inline void RTC_IRAM_ATTR wsRelease(uint32_t pin) {
+  REG_WRITE(GPIO_ENABLE_W1TC_REG, BIT(pin));
+}
+
+static inline uint32_t RTC_IRAM_ATTR wsRead(uint32_t pin) {
+  return (REG_READ(GPIO_IN_REG) >> pin) & 1;
+}
+
+static inline void RTC_IRAM_ATTR wsDelay() {
+  esp_rom_delay_us(WAKE_STUB_I2C_HALF_PERIOD_US);
+}
+
+static void RTC_IRAM_ATTR wsI2cBegin() {
+  REG_WRITE(GPIO_OUT_W1TC_REG, BIT(PIN_LSM_SDA) | BIT(PIN_LSM_SCL));
+  REG_WRITE(GPIO_ENABLE_W1TC_REG, BIT(PIN_LSM_SDA) | BIT(PIN_LSM_SCL));
+  REG_WRITE(GPIO_FUNC0_OUT_SEL_CFG_REG + PIN_LSM_SDA * 4, SIG_GPIO_OUT_IDX);
+  REG_WRITE(GPIO_FUNC0_OUT_SEL_CFG_REG + PIN_LSM_SCL * 4, SIG_GPIO_OUT_IDX);
+  PIN_FUNC_SELECT(WS_IOMUX_REG(PIN_LSM_SDA), PIN_FUNC_GPIO);
+  PIN_FUNC_SELECT(WS_IOMUX_REG(PIN_LSM_SCL), PIN_FUNC_GPIO);
+  PIN_INPUT_ENABLE(WS_IOMUX_REG(PIN_LSM_SDA));
+  PIN_INPUT_ENABLE(WS_IOMUX_REG(PIN_LSM_SCL));
+  PIN_PULLUP_EN(WS_IOMUX_REG(PIN_LSM_SDA));
+  PIN_PULLUP_EN(WS_IOMUX_REG(PIN_LSM_SCL));
+  wsDelay();
+}
+
+static void RTC_IRAM_ATTR wsStart() {
+  wsRelease(PIN_LSM_SDA);
+  wsRelease(PIN_LSM_SCL);
+  wsDelay();
+  wsLow(PIN_LSM_SDA);
+  wsDelay();
+  wsLow(PIN_LSM_SCL);
+}
+
+static void RTC_IRAM_ATTR wsStop() {
+  wsLow(PIN_LSM_SDA);
+  wsDelay();
+  wsRelease(PIN_LSM_SCL);
+  wsDelay();
+  wsRelease(PIN_LSM_SDA);
+  wsDelay();
+}
+
+/**
+ * @return true=从机应答 (ACK)
+ */
+static bool RTC_IRAM_ATTR wsWriteByte(uint8_t value) {
+  for (int i = 7; i >= 0; i--) {
+    if ((value >> i) & 1) {
+      wsRelease(PIN_LSM_SDA);
+    } else {
+      wsLow(PIN_LSM_SDA);
+    }
+    wsDelay();
+    wsRelease(PIN_LSM_SCL);
+    wsDelay();
+    wsLow(PIN_LSM_SCL);
+  }
+  wsRelease(PIN_LSM_SDA);
+  wsDelay();
+  wsRelease(PIN_LSM_SCL);
+  wsDelay();
+  bool ack = (wsRead(PIN_LSM_SDA) == 0);
+  wsLow(PIN_LSM_SCL);
+  return ack;
+}
+
+static uint8_t RTC_IRAM_ATTR wsReadByte(bool ack) {
+  uint8_t value = 0;
+  wsRelease(PIN_LSM_SDA);
+  for (int i = 0; i < 8; i++) {
+    wsDelay();
+    wsRelease(PIN_LSM_SCL);
+    wsDelay();
+    value = (value << 1) | wsRead(PIN_LSM_SDA);
+    wsLow(PIN_LSM_SCL);
+  }
+  if (ack) {
+    wsLow(PIN_LSM_SDA);
+  }
+  wsDelay();
+  wsRelease(PIN_LSM_SCL);
+  wsDelay();
+  wsLow(PIN_LSM_SCL);
+  wsRelease(PIN_LSM_SDA);
+  return value;
+}
+
+/**
+ * @brief 突发读取三轴加速度（原始值 >> 2，保证后续乘积不溢出 int32）
+ */
+static bool RTC_IRAM_ATTR wsReadAccel(int32_t out[3]) {
+  uint8_t raw[6];
+  uint8_t addr = g_wakeStub.i2cAddr;
+
+  wsStart();
+  if (!wsWriteByte(addr << 1) || !wsWriteByte(LSM6DS3_OUTX_L_XL)) {
+    wsStop();
+    return false;
+  }
+  wsStart(); // 重复起始
+  if (!wsWriteByte((addr << 1) | 1)) {
+    wsStop();
+    return false;
+  }
+  for (int i = 0; i < 6; i++) {
+    raw[i] = wsReadByte(i < 5);
+  }
+  wsStop();
+
+  for (int i = 0; i < 3; i++) {
+    out[i] = (int16_t)(raw[2 * i] | (raw[2 * i + 1] << 8)) >> 2;
+  }
+  return true;
+}
+
+/**
+ * @brief 当前重力向量与参考向量夹角是否在阈值内（纯整数运算）
+ * @note 32×32→64 位乘法由硬件 MULL/MULSH 完成，不调用库函数
+ */
+static bool RTC_IRAM_ATTR wsWithinThreshold(const int32_t a[3]) {
+  const int32_t *r = g_wakeStub.ref;
+  int32_t dot = a[0] * r[0] + a[1] * r[1] + a[2] * r[2];
+  if (dot <= 0) return false;
+
+  int32_t cx = a[1] * r[2] - a[2] * r[1];
+  int32_t cy = a[2] * r[0] - a[0] * r[2];
+  int32_t cz = a[0] * r[1] - a[1] * r[0];
+  int64_t crossSq = (int64_t)cx * cx + (int64_t)cy * cy + (int64_t)cz * cz;
+  int32_t aSq = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+  return crossSq <= (int64_t)g_wakeStub.sinSqLimit * aSq;
+}
+
+extern "C" void esp_wake_deep_sleep(void);
+
+/**
+ * @brief 重设 RTC 定时器并立即重新进入深度睡眠（不返回）
+ */
+static void RTC_IRAM_ATTR wsSleepAgain() {
+  SET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_UPDATE);
+  uint64_t now = READ_PERI_REG(RTC_CNTL_TIME_LOW0_REG) |
+                 ((uint64_t)READ_PERI_REG(RTC_CNTL_TIME_HIGH0_REG) << 32);
+  uint64_t target = now + g_wakeStub.intervalTicks;
+  WRITE_PERI_REG(RTC_CNTL_SLP_TIMER0_REG, (uint32_t)target);
+  WRITE_PERI_REG(RTC_CNTL_SLP_TIMER1_REG, (uint32_t)(target >> 32));
+  SET_PERI_REG_MASK(RTC_CNTL_INT_CLR_REG, RTC_CNTL_MAIN_TIMER_INT_CLR_M);
+  SET_PERI_REG_MASK(RTC_CNTL_SLP_TIMER1_REG, RTC_CNTL_MAIN_TIMER_ALARM_EN_M);
+
+  REG_WRITE(RTC_ENTRY_ADDR_REG, (uint32_t)&esp_wake_deep_sleep);
+  CLEAR_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_SLEEP_EN);
+  SET_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_SLEEP_EN);
+  while (true) {
+  }
+}
+
+/**
+ * @brief 唤醒桩入口（覆盖 ESP-IDF 的弱符号）
+ */
+extern "C" void RTC_IRAM_ATTR esp_wake_deep_sleep(void) {
+  esp_default_wake_deep_sleep();
+
+  if (g_wakeStub.magic != WAKE_STUB_MAGIC || !g_wakeStub.armed) return;
+
+  uint32_t cause = REG_GET_FIELD(RTC_CNTL_SLP_WAKEUP_CAUSE_REG, RTC_CNTL_WAKEUP_CAUSE);
+  if (!(cause & RTC_TIMER_TRIG_EN)) {
+    g_wakeStub.lastResult = WAKE_STUB_OTHER_SRC;
+    return;
+  }
+  if (g_wakeStub.skipsLeft == 0) {
+    g_wakeStub.lastResult = WAKE_STUB_DUE;
+    return;
+  }
+
+  int32_t accel[3];
+  wsI2cBegin();
+  bool ok = wsReadAccel(accel);
+  wsRelease(PIN_LSM_SDA);
+  wsRelease(PIN_LSM_SCL);
+  if (!ok) {
+    g_wakeStub.lastResult = WAKE_STUB_I2C_FAIL;
+    return;
+  }
+  if (!wsWithinThreshold(accel)) {
+    g_wakeStub.lastResult = WAKE_STUB_TILTED;
+    return;
+  }
+
+  g_wakeStub.skipsLeft--;
+  g_wakeStub.skipped++;
+  g_wakeStub.lastResult = WAKE_STUB_SLEPT;
+  wsSleepAgain();
+}
+
+// ==========================================
+// 主程序侧（Flash）
+// ==========================================
+
+class WakeStub {
+public:
+  /**
+   * @brief 记录参考重力向量（与 g_initialPitch/g_initialRoll 同时校准）
+   * @param raw IMU 原始加速度
+   * @param i2cAddr IMU 地址
+   */
+  static void calibrate(const int16_t raw[3], uint8_t i2cAddr) {
+    ensureState();
+    int64_t refSq = 0;
+    for (int i = 0; i < 3; i++) {
+      g_wakeStub.ref[i] = raw[i] >> 2;
+      refSq += (int64_t)g_wakeStub.ref[i] * g_wakeStub.ref[i];
+    }
+    float limitDeg = max(TILT_THRESHOLD - WAKE_STUB_TILT_MARGIN, 0.0f);
+    float s = sinf(limitDeg * PI / 180.0f);
+    g_wakeStub.sinSqLimit = (int32_t)(s * s * (float)refSq);
+    g_wakeStub.i2cAddr = i2cAddr;
+    g_wakeStub.calibrated = (refSq > 0);
+    DEBUG_PRINTF("[唤醒桩] 参考向量 (%ld, %ld, %ld)\n", (long)g_wakeStub.ref[0],
+                 (long)g_wakeStub.ref[1], (long)g_wakeStub.ref[2]);
+  }
+
+  /**
+   * @brief 进入睡眠前调用：由唤醒桩接管本次睡眠
+   * @param seconds 计划睡眠时长
+   * @return 实际设置给定时器的时长（秒）
+   */
+  static uint32_t arm(uint32_t seconds) {
+    ensureState();
+    g_wakeStub.armed = false;
+    if (!g_wakeStub.calibrated || seconds < 2 * WAKE_STUB_INTERVAL_SEC) {
+      return seconds;
+    }
+
+    // RTC_SLOW_CLK_CAL_REG: 慢时钟周期，Q19 格式 (µs)
+    uint32_t cal = REG_READ(RTC_SLOW_CLK_CAL_REG);
+    if (cal == 0) return seconds;
+    g_wakeStub.intervalTicks =
+        (((uint64_t)WAKE_STUB_INTERVAL_SEC * 1000000ULL) << RTC_CLK_CAL_FRACT) / cal;
+    g_wakeStub.skipsLeft = seconds / WAKE_STUB_INTERVAL_SEC - 1;
+    g_wakeStub.skipped = 0;
+    g_wakeStub.lastResult = WAKE_STUB_NONE;
+    g_wakeStub.armed = true;
+    return WAKE_STUB_INTERVAL_SEC;
+  }
+
+  /**
+   * @brief 完整启动后调用：取出唤醒桩直接回睡的次数并清零
+   */
+  static uint16_t takeSkipped() {
+    ensureState();
+    uint16_t n = g_wakeStub.skipped;
+    if (g_wakeStub.armed) {
+      DEBUG_PRINTF("[唤醒桩] 已直接回睡 %u 次，本次完整启动原因: %u\n", n,
+                   g_wakeStub.lastResult);
+    }
+    g_wakeStub.skipped = 0;
+    g_wakeStub.armed = false;
+    return n;
+  }
+
+private:
+  static void ensureState() {
+    if (g_wakeStub.magic != WAKE_STUB_MAGIC) {
+      memset(&g_wakeStub, 0, sizeof(g_wakeStub));
+      g_wakeStub.magic = WAKE_STUB_MAGIC;
+    }
+  }
+};
+
+#endif // WAKE_STUB_ACTIVE
@@ -14,7 +14,17 @@
 #include "../modules/real/LSM6DS3_Sensor.h"
 #include "../modules/real/AudioSensor_ADC.h"
 #include "../utils/DataPayload.h"
+#include "../utils/DeltaReporter.h"
+#include "../utils/EnergyLedger.h"
+#include "../utils/ImageCache.h"
+#include "../utils/SampleBatch.h"
+#include "../utils/TelemetryQueue.h"
+#include "../utils/TiltTrend.h"
+#include "../utils/WakeHoldoff.h"
+#include "../utils/WakeProfiler.h"
+#include "AlarmPipeline.h"
 #include "DeviceFactory.h"
+#include "StateMachine.h"
 #include "SystemManager.h"
 
 class WorkflowManager {
@@ -32,11 +42,24 @@ public:
     }
 
     LSM6DS3_Sensor *lsm = static_cast<LSM6DS3_Sensor *>(tiltSensor);
-    float initialPitch = lsm->getAbsolutePitch();
-    float initialRoll = lsm->getAbsoluteRoll();
+    float initialPitch = 0.0f, initialRoll = 0.0f;
+    if (!lsm->readPose(initialPitch, initialRoll)) {
+      DEBUG_PRINTLN("[传感器] ❌ 读取失败");
+      DeviceFactory::destroy(tiltSensor);
+      return;
+    }
 
     SystemManager::calibrateInitialPose(initialPitch, initialRoll);
     lsm->calibrate(initialPitch, initialRoll);
+    TiltTrend::clear();
+#if ENABLE_TILT_FUSION && !USE_MOCK_HARDWARE
+    lsm->calibrateGyroBias();
+#endif
+#if WAKE_STUB_ACTIVE
+    int16_t rawAccel[3];
+    lsm->readRawAccel(rawAccel);
+    WakeStub::calibrate(rawAccel, lsm->getAddress());
+#endif
 
     DEBUG_PRINTLN("[系统] ✓ 零点校准完成");
 
@@ -51,104 +74,243 @@ public:
   /**
    * @brief 定时器唤醒 - 心跳巡检流程
    */
-  static void handleTimerWakeup() {
-    float batteryVoltage = SystemManager::readBatteryVoltage();
-    int batteryPercent = SystemManager::getBatteryPercentage();
-    DEBUG_PRINTF("[巡检] 电池: %.2fV (%d%%)\n", batteryVoltage, batteryPercent);
-
-    // 1. 读取倾角
-    float relativeAngle = readTiltAngle();
-    if (relativeAngle < 0) {
-      SystemManager::deepSleep(HEARTBEAT_INTERVAL_SEC);
-      return;
-    }
-    DEBUG_PRINTF("[巡检] 倾角: %.2f°\n", relativeAngle);
+  static void handleTimerWakeup() { runWakeCycle(ESP_SLEEP_WAKEUP_TIMER); }
 
-    // 2. 读取声音
-    uint16_t soundLevel = 0;
-    float soundDb = 30.0f;
-    IAudio *audioSensor = DeviceFactory::createAudioSensor();
-    if (audioSensor && audioSensor->init()) {
-      soundLevel = audioSensor->readPeakToPeak();
-      AudioSensor_ADC *adcSensor = static_cast<AudioSensor_ADC *>(audioSensor);
-      soundDb = adcSensor->getLastDb();
-      DEBUG_PRINTF("[巡检] 声音: %.0f dB (峰峰值=%d)\n", soundDb, soundLevel);
+  /**
+   * @brief 声音中断唤醒 - 噪音报警流程
+   */
+  static void handleAudioWakeup() {
+    DEBUG_PRINTLN("[报警] 声音中断唤醒");
+    runWakeCycle(ESP_SLEEP_WAKEUP_EXT0);
+  }
+
+  /**
+   * @brief 倾斜中断唤醒 (EXT1) - 复核倾角后报警
+   */
+  static void handleTiltWakeup() {
+    DEBUG_PRINTLN("[报警] 倾斜中断唤醒");
+    runWakeCycle(ESP_SLEEP_WAKEUP_EXT1);
+  }
+
+  /**
+   * @brief 上周期报警中途被打断（看门狗/panic/软件重启）时从 ALARM 状态恢复
+   * @return false=无待恢复的报警
+   */
+  static bool handleInterruptedAlarm() {
+    if (!StateMachine::hasPendingAlarm()) return false;
+    runWakeCycle(ESP_SLEEP_WAKEUP_UNDEFINED);
+    return true;
+  }
+
+  // ==========================================
+  // 🔁 唤醒状态机 (见 StateMachine.h)
+  // ==========================================
+private:
+  static void runWakeCycle(esp_sleep_wakeup_cause_t cause) {
+    static const StateDef table[] = {
+        {STATE_INIT, stateInit, SM_BUDGET_INIT_MS, false},
+        {STATE_CHECK_BATTERY, stateCheckBattery, SM_BUDGET_BATTERY_MS, false},
+        {STATE_READ_SENSORS, stateReadSensors, SM_BUDGET_SENSORS_MS, false},
+        {STATE_EVALUATE, stateEvaluate, SM_BUDGET_EVALUATE_MS, false},
+        {STATE_ALARM, stateAlarm, SM_BUDGET_ALARM_MS, false},
+        {STATE_REPORT, stateReport, SM_BUDGET_REPORT_MS, true},
+        {STATE_SLEEP, stateSleep, SM_BUDGET_SLEEP_MS, false},
+        {STATE_ERROR, stateError, 0, false},
+    };
+
+    WakeContext ctx;
+    ctx.cause = cause;
+    StateMachine::run(table, sizeof(table) / sizeof(table[0]), ctx);
+  }
+
+  static SystemState stateInit(WakeContext &ctx) {
+    if (ctx.cause == ESP_SLEEP_WAKEUP_TIMER) {
+      WakeHoldoff::resetFalseWakes();
     }
+    return STATE_CHECK_BATTERY;
+  }
 
-    // 3. 检查倾斜阈值
-    if (relativeAngle > TILT_THRESHOLD) {
-      DEBUG_PRINTF("[报警] 🚨 倾斜: %.2f° > %.2f°\n", relativeAngle, TILT_THRESHOLD);
-      g_last_tilt_trigger_ms = millis();
+  static SystemState stateCheckBattery(WakeContext &ctx) {
+    ctx.batteryVoltage = SystemManager::readBatteryVoltage();
+    DEBUG_PRINTF("[巡检] 电池: %.2fV (%d%%)\n", ctx.batteryVoltage,
+                 SystemManager::voltageToPercentage(ctx.batteryVoltage));
+    return STATE_READ_SENSORS;
+  }
 
-      if (audioSensor) {
-        audioSensor->sleep();
-        DeviceFactory::destroy(audioSensor);
-      }
+  /**
+   * @brief 采样：定时/倾斜唤醒读倾角 + 声音，声音唤醒只读声音；传感器用完即释放
+   */
+  static SystemState stateReadSensors(WakeContext &ctx) {
+    bool timerWake = (ctx.cause == ESP_SLEEP_WAKEUP_TIMER);
+    bool tiltWake = (ctx.cause == ESP_SLEEP_WAKEUP_EXT1);
+
+    if (timerWake || tiltWake) {
+      ctx.tiltAngle = readTiltAngle(tiltWake);
+      if (ctx.tiltAngle < 0) return STATE_ERROR;
+      WakeProfiler::markFirstSample();
+      DEBUG_PRINTF("[巡检] 倾角: %.2f°\n", ctx.tiltAngle);
+    }
 
-      if (sendTiltAlarmWithPhoto(relativeAngle, batteryVoltage)) {
-        SystemManager::deepSleep(SLEEP_DURATION_ALARM);
-        return;
+    IAudio *audioSensor = DeviceFactory::createAudioSensor();
+    bool audioReady = false;
+    {
+      ProfileSpan span(PHASE_AUDIO);
+      audioReady = audioSensor && audioSensor->init();
+      if (audioReady) {
+        uint16_t soundLevel = audioSensor->readPeakToPeak();
+        AudioSensor_ADC *adcSensor = static_cast<AudioSensor_ADC *>(audioSensor);
+        ctx.soundDb = adcSensor->getLastDb();
+        ctx.noiseDetected = audioSensor->isNoiseDetected();
+        if (ctx.noiseDetected) {
+          // 先录音再分类：分类 (FFT) 期间 DMA 环形缓冲会写满，触发后的声音出现缺口
+          adcSensor->captureClip();
+          ctx.soundClass = adcSensor->classify();
+          if (SoundClassifier::isSuppressed(ctx.soundClass)) {
+            AudioClip::release(); // 不报警，录音不会上传
+          }
+        }
+        WakeProfiler::markFirstSample();
+        DEBUG_PRINTF("[巡检] 声音: %.0f dB (峰峰值=%d)\n", ctx.soundDb, soundLevel);
       }
     }
-
-    // 4. 检查声音阈值
-    if (audioSensor && audioSensor->isNoiseDetected()) {
-      DEBUG_PRINTF("[报警] 🚨 噪音: %.0f dB > %d dB\n", soundDb, NOISE_THRESHOLD_DB);
+    if (audioSensor) {
       audioSensor->sleep();
       DeviceFactory::destroy(audioSensor);
+    }
 
-      if (sendNoiseAlarmWithPhoto(batteryVoltage, soundDb)) {
-        SystemManager::deepSleep(SLEEP_DURATION_ALARM);
-        return;
-      }
-    } else {
-      if (audioSensor) {
-        audioSensor->sleep();
-        DeviceFactory::destroy(audioSensor);
-      }
+    if (!audioReady && !timerWake && !tiltWake) {
+      DEBUG_PRINTLN("[报警] ⚠️ 传感器初始化失败");
+      return STATE_ERROR;
     }
 
-    // 5. 正常心跳（包含所有传感器数据）
-    sendStatusHeartbeat(relativeAngle, batteryVoltage, soundDb);
-    SystemManager::deepSleep(HEARTBEAT_INTERVAL_SEC);
+#if ENABLE_HEARTBEAT_BATCH
+    if (timerWake) {
+      SampleBatch::add(ctx.tiltAngle, ctx.soundDb, ctx.batteryVoltage);
+    }
+#endif
+    if (timerWake) {
+      TiltTrend::add(ctx.tiltAngle);
+    }
+#if ENABLE_DELTA_REPORT
+    if (timerWake) {
+      DeltaReporter::observe(ctx.tiltAngle, ctx.soundDb, ctx.batteryVoltage);
+    }
+#endif
+    return STATE_EVALUATE;
+  }
+
+  static SystemState stateEvaluate(WakeContext &ctx) {
+    bool tiltRead = (ctx.cause == ESP_SLEEP_WAKEUP_TIMER || ctx.cause == ESP_SLEEP_WAKEUP_EXT1);
+    if (tiltRead && ctx.tiltAngle > TILT_THRESHOLD) {
+      DEBUG_PRINTF("[报警] 🚨 倾斜: %.2f° > %.2f°\n", ctx.tiltAngle, TILT_THRESHOLD);
+      g_last_tilt_trigger_ms = millis();
+      ctx.tiltAlarm = true;
+    } else if (ctx.cause == ESP_SLEEP_WAKEUP_TIMER && TiltTrend::isCreepAlarmDue()) {
+      ctx.creepAlarm = true;
+    }
+    if (ctx.noiseDetected && SoundClassifier::isSuppressed(ctx.soundClass)) {
+      DEBUG_PRINTF("[报警] 噪音 %.0f dB 判定为 %s，不报警\n", ctx.soundDb,
+                   SoundClassifier::label(ctx.soundClass));
+    } else if (ctx.noiseDetected) {
+      DEBUG_PRINTF("[报警] 🚨 噪音: %.0f dB (%s)\n", ctx.soundDb,
+                   SoundClassifier::label(ctx.soundClass));
+      ctx.noiseAlarm = true;
+    }
+    if (ctx.tiltAlarm || ctx.noiseAlarm || ctx.creepAlarm) return STATE_ALARM;
+
+    if (ctx.cause == ESP_SLEEP_WAKEUP_EXT0 || ctx.cause == ESP_SLEEP_WAKEUP_EXT1) {
+      DEBUG_PRINTLN("[报警] ⚠️ 误触发");
+      if (ctx.cause == ESP_SLEEP_WAKEUP_EXT1) {
+        WakeHoldoff::recordFalseWake(WAKE_SRC_TILT, TILT_WAKE_FALSE_LIMIT, TILT_WAKE_HOLDOFF_SEC);
+      } else {
+        WakeHoldoff::recordFalseWake(WAKE_SRC_SOUND, ULP_SOUND_FALSE_LIMIT,
+                                     ULP_SOUND_HOLDOFF_SEC);
+      }
+      ctx.sleepSec = remainingPatrolSec(); // 不推迟下一次巡检
+      return STATE_SLEEP;
+    }
+    return reportOrSleep(ctx);
   }
 
   /**
-   * @brief 声音中断唤醒 - 噪音报警流程
+   * @brief 报警：倾斜优先，发送失败再依次尝试噪音、蠕变；巡检中报警全部失败则继续心跳
    */
-  static void handleAudioWakeup() {
-    DEBUG_PRINTLN("[报警] 声音中断唤醒");
+  static SystemState stateAlarm(WakeContext &ctx) {
+    flushSampleBatch();
 
-    float batteryVoltage = SystemManager::readBatteryVoltage();
-    int batteryPercent = SystemManager::getBatteryPercentage();
-    DEBUG_PRINTF("[巡检] 电池: %.2fV (%d%%)\n", batteryVoltage, batteryPercent);
+    bool sent = false;
+    if (ctx.tiltAlarm) {
+      sent = sendTiltAlarmWithPhoto(ctx.tiltAngle, ctx.batteryVoltage);
+    }
+    if (!sent && ctx.noiseAlarm) {
+      sent = sendNoiseAlarmWithPhoto(ctx.batteryVoltage, ctx.soundDb, ctx.soundClass);
+    }
+    if (!sent && ctx.creepAlarm) {
+      sent = sendCreepAlarmWithPhoto(ctx.tiltAngle, ctx.batteryVoltage);
+    }
 
-    IAudio *audioSensor = DeviceFactory::createAudioSensor();
-    if (!audioSensor || !audioSensor->init()) {
-      DEBUG_PRINTLN("[报警] ⚠️ 传感器初始化失败");
-      if (audioSensor) {
-        DeviceFactory::destroy(audioSensor);
-      }
-      SystemManager::deepSleep(HEARTBEAT_INTERVAL_SEC);
-      return;
+    if (sent || ctx.cause != ESP_SLEEP_WAKEUP_TIMER) {
+      ctx.sleepSec = SLEEP_DURATION_ALARM;
+      return STATE_SLEEP;
     }
-    
-    audioSensor->readPeakToPeak();  // 先读取
-    if (!audioSensor->isNoiseDetected()) {
-      DEBUG_PRINTLN("[报警] ⚠️ 误触发");
-      audioSensor->sleep();
-      DeviceFactory::destroy(audioSensor);
-      SystemManager::deepSleep(HEARTBEAT_INTERVAL_SEC);
-      return;
+    return reportOrSleep(ctx);
+  }
+
+  static SystemState stateReport(WakeContext &ctx) {
+    bool delivered = sendStatusHeartbeat(ctx.tiltAngle, ctx.batteryVoltage, ctx.soundDb);
+#if ENABLE_DELTA_REPORT
+    // 队列写入失败时不更新快照，下次巡检照常上报，而非沉默到 DELTA_MAX_SILENCE_SEC
+    if (delivered) {
+      DeltaReporter::markReported(ctx.tiltAngle, ctx.soundDb, ctx.batteryVoltage);
     }
+#endif
+    ctx.sleepSec = PATROL_INTERVAL_SEC;
+    return STATE_SLEEP;
+  }
 
-    AudioSensor_ADC *adcSensor = static_cast<AudioSensor_ADC *>(audioSensor);
-    float soundDb = adcSensor->getLastDb();
-    audioSensor->sleep();
-    DeviceFactory::destroy(audioSensor);
+  static SystemState stateSleep(WakeContext &ctx) {
+    nextTimerWakeAt = rtcNowSeconds() + ctx.sleepSec;
+    SystemManager::deepSleep(ctx.sleepSec);
+    return STATE_SLEEP;
+  }
+
+  static SystemState stateError(WakeContext &ctx) {
+    ctx.sleepSec = PATROL_INTERVAL_SEC;
+    return STATE_SLEEP;
+  }
+
+  /**
+   * @brief 距上次排定的定时唤醒还剩的秒数（中断误唤醒后沿用原巡检计划）
+   */
+  static uint32_t remainingPatrolSec() {
+    uint32_t now = rtcNowSeconds();
+    if (nextTimerWakeAt <= now || nextTimerWakeAt - now > PATROL_INTERVAL_SEC) {
+      return PATROL_INTERVAL_SEC; // 无计划或时钟异常
+    }
+    return max(nextTimerWakeAt - now, (uint32_t)1);
+  }
 
-    sendNoiseAlarmWithPhoto(batteryVoltage, soundDb);
-    SystemManager::deepSleep(SLEEP_DURATION_ALARM);
+  /**
+   * @brief 巡检收尾：批量模式下未满一批、或读数均无变化则不联网
+   */
+  static SystemState reportOrSleep(WakeContext &ctx) {
+    ctx.sleepSec = PATROL_INTERVAL_SEC;
+#if ENABLE_HEARTBEAT_BATCH
+    if (!SampleBatch::isUploadDue()) {
+      DEBUG_PRINTLN("[批量] 未满一批，跳过联网");
+      return STATE_SLEEP;
+    }
+#endif
+#if ENABLE_DELTA_REPORT
+    if (!DeltaReporter::isReportDue()) {
+      DEBUG_PRINTLN("[变化] 读数均在死区内，跳过联网");
+#if ENABLE_HEARTBEAT_BATCH
+      SampleBatch::clear(); // 整批均与上次上报无异
+#endif
+      return STATE_SLEEP;
+    }
+#endif
+    return STATE_REPORT;
   }
 
   // ==========================================
@@ -157,6 +319,7 @@ public:
 public:
   static uint32_t lastGpsUploadTime;      // 上次 GPS 上传时间
   static uint32_t g_last_tilt_trigger_ms; // 上次倾斜触发时间 (用于联动)
+  static uint32_t nextTimerWakeAt;        // 下一次定时唤醒时刻 (RTC 秒)
 
   static uint32_t getLastTiltTime() { return g_last_tilt_trigger_ms; }
 
@@ -185,6 +348,7 @@ private:
                  gpsData.latitude, gpsData.longitude);
 
         char serverResponse[64];
+        ProfileSpan span(PHASE_HTTP);
         commModule->sendStatus(gpsMsg, serverResponse, sizeof(serverResponse));
 
         DEBUG_PRINTF("[GPS] 📤 发送: %s\n", gpsMsg);
@@ -197,9 +361,13 @@ private:
 private:
   /**
    * @brief 读取倾角数据（相对于初始位置）
+   * @param settle true=中断唤醒：间隔 TILT_SAMPLE_INTERVAL_MS 读 TILT_DEBOUNCE_COUNT 次
+   *               瞬时倾角取最小值，敲击/晃动后回正的杆体不会报警
+   *               （ENABLE_TILT_FUSION 时两种唤醒都走陀螺仪融合 + 同样的防抖窗口）
    * @return 相对倾角，失败返回 -1
    */
-  static float readTiltAngle() {
+  static float readTiltAngle(bool settle = false) {
+    ProfileSpan span(PHASE_TILT);
     ISensor *tiltSensor = DeviceFactory::createTiltSensor();
     if (!tiltSensor) {
       DEBUG_PRINTLN("[传感器] ❌ 创建失败");
@@ -225,7 +393,21 @@ private:
     float initialRoll = SystemManager::getInitialRoll();
     lsm->calibrate(initialPitch, initialRoll);
 
-    float relativeAngle = tiltSensor->readData();
+    float relativeAngle;
+#if ENABLE_TILT_FUSION && !USE_MOCK_HARDWARE
+    relativeAngle = lsm->readFusedTilt(settle);
+#else
+    if (settle) {
+      relativeAngle = lsm->readInstantTilt();
+      for (int i = 1; i < TILT_DEBOUNCE_COUNT && relativeAngle >= 0; i++) {
+        delay(TILT_SAMPLE_INTERVAL_MS);
+        float angle = lsm->readInstantTilt();
+        relativeAngle = (angle < 0) ? angle : min(relativeAngle, angle);
+      }
+    } else {
+      relativeAngle = tiltSensor->readData();
+    }
+#endif
 
 #if ENABLE_DEEP_SLEEP
     tiltSensor->sleep();
@@ -243,6 +425,7 @@ private:
     // GPS 已禁用
     return false;
 #else
+    ProfileSpan span(PHASE_GPS);
     IGPS *gps = DeviceFactory::createGpsModule();
     if (!gps || !gps->init()) {
       DeviceFactory::destroy(gps);
@@ -263,113 +446,97 @@ private:
   }
 
   /**
-   * @brief 统一报警处理流程
+   * @brief 统一报警处理流程（GPS/网络/相机并行，见 AlarmPipeline.h）
    */
-  static bool dispatchAlarm(const char *type, float value, float voltage) {
-    // 1. 获取 GPS
-    GpsData gpsData;
-    bool hasGps = getGpsLocation(gpsData);
-
-    // 2. 初始化通信
-    IComm *commModule = DeviceFactory::createCommModule();
-    if (!commModule || !commModule->init() || !commModule->connectNetwork()) {
-      DEBUG_PRINTLN("[通信] ❌ 连接失败");
-      DeviceFactory::destroy(commModule);
-      return false;
-    }
-
-    // 3. 拍照上传
-    ICamera *camera = DeviceFactory::createCamera();
-    if (camera && camera->init()) {
-      uint8_t *photoBuffer = nullptr;
-      size_t photoSize = 0;
-      if (camera->capturePhoto(&photoBuffer, &photoSize)) {
-        DEBUG_PRINTF("[上报] 📷 图片: %d bytes\n", photoSize);
-        String metadata = String("{\"device_id\":\"") + HTTP_DEVICE_ID +
-                         "\",\"type\":\"" + type + "\"}";
-        if (commModule->uploadImage(photoBuffer, photoSize, metadata.c_str())) {
-          DEBUG_PRINTLN("[上报] ✓ 图片上传成功");
-        } else {
-          DEBUG_PRINTLN("[上报] ⚠️ 图片上传失败");
-        }
-      }
-      camera->releasePhoto();
-      camera->powerOff();
-      DeviceFactory::destroy(camera);
-    }
-
-    // 4. 构建并发送报警
-    String alarmJson;
-    if (strcmp(type, "tilt") == 0) {
-      if (hasGps) {
-        alarmJson = TiltAlarmPayload(value, voltage, gpsData.latitude,
-                                     gpsData.longitude).toJson();
-      } else {
-        alarmJson = TiltAlarmPayload(value, voltage).toJson();
-      }
-    } else {
-      // noise: value 是分贝值
-      if (hasGps) {
-        alarmJson = NoiseAlarmPayload(voltage, value,
-                                      gpsData.latitude, gpsData.longitude)
-                        .toJson();
-      } else {
-        alarmJson = NoiseAlarmPayload(voltage, value).toJson();
-      }
-    }
-
-    DEBUG_PRINTF("[上报] 📤 %s报警: %s\n", 
-                 strcmp(type, "tilt") == 0 ? "倾斜" : "噪音", 
-                 alarmJson.c_str());
-
-    char serverResponse[256] = {0};
-    bool success = commModule->sendAlarm(alarmJson.c_str(), serverResponse,
-                                         sizeof(serverResponse));
-    if (success) {
-      DEBUG_PRINTLN("[上报] ✓ 发送成功");
-    }
-
-    commModule->sleep();
-    DeviceFactory::destroy(commModule);
-    return success;
+  static bool dispatchAlarm(const char *type, float value, float voltage,
+                            const char *label = nullptr) {
+    return AlarmPipeline::run(type, value, voltage, label);
   }
 
   static bool sendTiltAlarmWithPhoto(float angle, float voltage) {
     return dispatchAlarm("tilt", angle, voltage);
   }
 
-  static bool sendNoiseAlarmWithPhoto(float voltage, float soundDb) {
-    return dispatchAlarm("noise", soundDb, voltage);
+  static bool sendNoiseAlarmWithPhoto(float voltage, float soundDb, uint8_t soundClass) {
+    return dispatchAlarm("noise", soundDb, voltage, SoundClassifier::label(soundClass));
+  }
+
+  static bool sendCreepAlarmWithPhoto(float angle, float voltage) {
+    bool sent = dispatchAlarm("creep", angle, voltage);
+    if (sent) TiltTrend::markAlarmed();
+    return sent;
   }
 
   /**
    * @brief 发送状态心跳（包含所有传感器数据）
+   * @return true=已送达或确已写入断网队列
    */
-  static void sendStatusHeartbeat(float angle, float voltage, float soundDb) {
+  static bool sendStatusHeartbeat(float angle, float voltage, float soundDb) {
     GpsData gpsData;
     bool hasGps = getGpsLocation(gpsData);
 
-    IComm *commModule = DeviceFactory::createCommModule();
-    if (!commModule || !commModule->init() || !commModule->connectNetwork()) {
-      DEBUG_PRINTLN("[通信] ❌ 连接失败");
-      DeviceFactory::destroy(commModule);
-      return;
-    }
-
+    // 先构建负载，连接失败时可直接缓存
     StatusPayload statusData;
     if (hasGps) {
       statusData = StatusPayload(angle, voltage, soundDb, gpsData.latitude, gpsData.longitude);
     } else {
       statusData = StatusPayload(angle, voltage, soundDb);
     }
-
+    statusData.profile = WakeProfiler::summaryJson();
+    statusData.energy =
+        EnergyLedger::summaryJson(SystemManager::voltageToPercentage(voltage));
+    bool batchIncluded = false; // 样本确已写入本条心跳，才可在送达/入队后清空
+#if ENABLE_HEARTBEAT_BATCH
+    statusData.samples = SampleBatch::toJson();
+    batchIncluded = statusData.samples.length() > 0;
+#endif
     String statusJson = statusData.toJson();
+    if (statusJson.length() == 0) {
+      DEBUG_PRINTLN("[上报] ⚠️ 心跳 JSON 超出容量，本次不带批量样本");
+      statusData.samples = String();
+      batchIncluded = false;
+      statusJson = statusData.toJson();
+    }
+
+    IComm *commModule = DeviceFactory::createCommModule();
+    bool online = false;
+    {
+      ProfileSpan span(PHASE_WIFI);
+      online = commModule && commModule->init() && commModule->connectNetwork();
+    }
+    if (!online) {
+      DEBUG_PRINTLN("[通信] ❌ 连接失败");
+      bool queued = false;
+#if ENABLE_TELEMETRY_QUEUE
+      queued = TelemetryQueue::push(statusJson.c_str());
+#if ENABLE_HEARTBEAT_BATCH
+      if (queued && batchIncluded) {
+        SampleBatch::clear(); // 样本已随心跳写入队列
+      }
+#endif
+#endif
+      DeviceFactory::destroy(commModule);
+      return queued;
+    }
+
     DEBUG_PRINTF("[上报] 📤 心跳: %s\n", statusJson.c_str());
 
     char serverResponse[256] = {0};
     uploadGpsIfNeeded(commModule);
 
-    if (commModule->sendStatus(statusJson.c_str(), serverResponse, sizeof(serverResponse))) {
+    bool sent = false;
+    bool queued = false;
+    {
+      ProfileSpan span(PHASE_HTTP);
+      sent = deliverStatus(commModule, statusJson, serverResponse, sizeof(serverResponse), queued);
+    }
+#if ENABLE_HEARTBEAT_BATCH
+    // 已送达，或确已写入断网队列，样本均不会丢失
+    if (batchIncluded && (sent || queued)) {
+      SampleBatch::clear();
+    }
+#endif
+    if (sent) {
       DEBUG_PRINTLN("[上报] ✓ 发送成功");
       // 解析服务器指令
       if (strlen(serverResponse) > 0 && strstr(serverResponse, "\"command\"")) {
@@ -377,10 +544,53 @@ private:
           DEBUG_PRINTLN("[系统] 执行重启指令");
           ESP.restart();
         }
+        ImageCache::handleDownlink(commModule, serverResponse);
       }
     }
 
     commModule->sleep();
     DeviceFactory::destroy(commModule);
+    return sent || queued;
+  }
+
+  /**
+   * @brief 报警前把未上报的批量样本写入断网队列，由报警会话一并补发
+   * @note 未启用断网队列时样本留在 RTC 中，随下一次心跳上报
+   */
+  static void flushSampleBatch() {
+#if ENABLE_HEARTBEAT_BATCH && ENABLE_TELEMETRY_QUEUE
+    if (SampleBatch::count() == 0) return;
+    String json = String("{\"type\":\"SAMPLES\",\"samples\":") +
+                  SampleBatch::toJson() + "}";
+    if (TelemetryQueue::push(json.c_str())) {
+      SampleBatch::clear();
+    }
+#endif
+  }
+
+  /**
+   * @brief 发送心跳；有积压时并入队列随积压一次批量发出，失败则缓存
+   * @param queued 输出：本条心跳确已写入断网队列（未送达时仍待补发）
+   * @return true=本条心跳已送达
+   */
+  static bool deliverStatus(IComm *commModule, const String &statusJson,
+                            char *serverResponse, size_t maxResponseLen, bool &queued) {
+    queued = false;
+#if ENABLE_TELEMETRY_QUEUE
+    if (!TelemetryQueue::isEmpty()) {
+      queued = TelemetryQueue::push(statusJson.c_str());
+      bool drained = TelemetryQueue::drain(commModule, serverResponse, maxResponseLen);
+      if (queued) return drained;
+      // 写入失败：积压照常补发，本条直接发送
+      return commModule->sendStatus(statusJson.c_str(), serverResponse, maxResponseLen);
+    }
+    if (!commModule->sendStatus(statusJson.c_str(), serverResponse, maxResponseLen)) {
+      queued = TelemetryQueue::push(statusJson.c_str());
+      return false;
+    }
+    return true;
+#else
+    return commModule->sendStatus(statusJson.c_str(), serverResponse, maxResponseLen);
+#endif
   }
 };
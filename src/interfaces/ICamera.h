@@ -44,4 +44,15 @@ public:
      * @brief 检查是否已初始化
      */
     virtual bool isReady() const = 0;
+
+    /**
+     * @brief 设置单张照片字节预算（须在 init() 之前调用）
+     * @param bytes 目标 JPEG 大小，init() 据此调整本次 JPEG 质量
+     */
+    virtual void setByteBudget(size_t bytes) = 0;
+
+    /**
+     * @brief 当前 JPEG 质量 (0-63, 越小越好)
+     */
+    virtual int getJpegQuality() const = 0;
 };
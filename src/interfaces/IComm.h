@@ -50,6 +50,15 @@ public:
      */
     virtual bool uploadImage(const uint8_t* imageData, size_t imageSize, const char* metadata = nullptr) = 0;
 
+    /**
+     * @brief 上传录音片段（HTTP POST 二进制）
+     * @param audioData IMA-ADPCM 数据指针
+     * @param audioSize 数据大小（字节）
+     * @param metadata 元数据 JSON（采样率、样本数、解码初值等）
+     * @return true=上传成功, false=上传失败
+     */
+    virtual bool uploadAudio(const uint8_t* audioData, size_t audioSize, const char* metadata = nullptr) = 0;
+
     /**
      * @brief 让通信模块进入低功耗模式（断开网络，DTR 休眠）
      */
@@ -6,19 +6,39 @@
  */
 
 #include "../include/AppConfig.h"
+#include "core/StateMachine.h"
 #include "core/SystemManager.h"
 #include "core/WorkflowManager.h"
+#include "utils/DeltaReporter.h"
+#include "utils/EnergyLedger.h"
+#include "utils/FlashFs.h"
+#include "utils/NoiseFloor.h"
+#include "utils/PowerManager.h"
+#include "utils/SampleBatch.h"
+#include "utils/TiltTrend.h"
+#include "utils/WakeHoldoff.h"
+#include "utils/WakeProfiler.h"
 #include <Arduino.h>
 
 // ==================== 全局变量 ====================
 esp_sleep_wakeup_cause_t wakeupCause;
 
-// RTC 内存：跨越重启保持
+// RTC 内存：跨越深度睡眠保持（其余复位由引导程序重新初始化）
 RTC_DATA_ATTR uint32_t bootCount = 0;
+RTC_DATA_ATTR WakeProfileRing WakeProfiler::ring; // 唤醒周期耗时记录
+RTC_DATA_ATTR EnergyLedgerState EnergyLedger::state; // 能耗账本
+RTC_DATA_ATTR SampleBatchState SampleBatch::state;   // 心跳批量样本
+RTC_DATA_ATTR StateMachineRtc StateMachine::rtc;     // 唤醒状态机
+RTC_NOINIT_ATTR PendingAlarmRecord StateMachine::pending; // 待完成报警（跨越看门狗/软件重启）
+RTC_DATA_ATTR DeltaReportState DeltaReporter::state; // 上次上报快照
+RTC_DATA_ATTR NoiseFloorState NoiseFloor::state;     // 噪音自适应基线
+RTC_DATA_ATTR TiltTrendState TiltTrend::state;       // 倾角日均值与回归累加量
+RTC_DATA_ATTR WakeHoldoffState WakeHoldoff::state;   // 中断误唤醒退避
 
 // WorkflowManager RTC 变量定义
 RTC_DATA_ATTR uint32_t WorkflowManager::lastGpsUploadTime = 0;
 RTC_DATA_ATTR uint32_t WorkflowManager::g_last_tilt_trigger_ms = 0;
+RTC_DATA_ATTR uint32_t WorkflowManager::nextTimerWakeAt = 0;
 
 // ==================== 函数声明 ====================
 void printBootBanner();
@@ -29,9 +49,21 @@ void setup() {
 #if DEBUG_SERIAL_ENABLE
   Serial.begin(115200);
 #endif
+  PowerManager::init();
+  FlashFs::init(); // 报警流水线的任务可能同时首次访问 LittleFS
+  UlpSoundMonitor::disarm(); // 让出 ADC1 给 DMA 采样
+#if ENABLE_FAST_BOOT
+  if (FAST_BOOT_SERIAL_WAIT_MS > 0) delay(FAST_BOOT_SERIAL_WAIT_MS);
+#else
   delay(500);
+#endif
 
   printBootBanner();
+  WakeProfiler::markBootComplete();
+  EnergyLedger::recordWake(); // 按实际睡眠时长记账（提前唤醒不多计）
+#if WAKE_STUB_ACTIVE
+  EnergyLedger::recordStubWakes(WakeStub::takeSkipped());
+#endif
 
   wakeupCause = esp_sleep_get_wakeup_cause();
   bootCount++;
@@ -79,14 +111,23 @@ void dispatchWakeupHandler() {
     break;
 
   case ESP_SLEEP_WAKEUP_EXT0:
+  case ESP_SLEEP_WAKEUP_ULP:
     WorkflowManager::handleAudioWakeup();
     break;
 
+  case ESP_SLEEP_WAKEUP_EXT1:
+    WorkflowManager::handleTiltWakeup();
+    break;
+
   case ESP_SLEEP_WAKEUP_UNDEFINED:
   default:
+    // 报警中途看门狗/panic/软件重启：从 ALARM 状态恢复（见 StateMachine.h）
+    if (WorkflowManager::handleInterruptedAlarm()) {
+      break;
+    }
     // 首次启动：执行校准
     WorkflowManager::handleFirstBoot();
-    SystemManager::deepSleep(HEARTBEAT_INTERVAL_SEC);
+    SystemManager::deepSleep(PATROL_INTERVAL_SEC);
     break;
   };
 }
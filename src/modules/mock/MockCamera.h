@@ -167,6 +167,14 @@ public:
     bool isReady() const override {
         return initialized;
     }
+
+    void setByteBudget(size_t bytes) override {
+        DEBUG_PRINTF("[MockCamera] 字节预算 %d bytes（模拟数据大小固定）\n", bytes);
+    }
+
+    int getJpegQuality() const override {
+        return CAM_JPEG_QUALITY;
+    }
     
     // ========== 辅助方法 ==========
     
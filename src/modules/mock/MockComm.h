@@ -64,6 +64,19 @@ public:
         return true;
     }
 
+    bool uploadAudio(const uint8_t* audioData, size_t audioSize, const char* metadata = nullptr) override {
+        DEBUG_PRINTLN("\n╔══════════ HTTP POST 录音 ══════════╗");
+        DEBUG_PRINTF("║ URL: http://%s%s\n", HTTP_SERVER_HOST, HTTP_API_AUDIO);
+        DEBUG_PRINTF("║ Size: %d bytes\n", audioSize);
+        if (metadata) {
+            DEBUG_PRINTF("║ Metadata: %s\n", metadata);
+        }
+        DEBUG_PRINTLN("╚════════════════════════════════════╝\n");
+        
+        delay(100); // 模拟上传延迟
+        return true;
+    }
+
     void sleep() override {
         DEBUG_PRINTLN("[MockComm] 进入休眠模式 (DTR=HIGH, 网络断开)");
     }
@@ -39,12 +39,23 @@ public:
     pinMode(PIN_GPS_PWR, OUTPUT);
     digitalWrite(PIN_GPS_PWR, LOW);
     isPowered = true;
+
+#if ENABLE_FAST_BOOT
+    // 上电即打开串口，收到首个 NMEA 字节即视为就绪
+    gpsSerial.begin(GPS_BAUD_RATE, SERIAL_8N1, PIN_GPS_RX, PIN_GPS_TX);
+    uint32_t start = millis();
+    while (!gpsSerial.available() && millis() - start < GPS_READY_TIMEOUT_MS) {
+      delay(10);
+    }
+    DEBUG_PRINTF("[GPS] ✓ 模块就绪 (%lu ms)\n", millis() - start);
+#else
     delay(500);
 
     gpsSerial.begin(9600, SERIAL_8N1, PIN_GPS_RX, PIN_GPS_TX);
     delay(2000);
 
     DEBUG_PRINTLN("[GPS] ✓ 模块就绪");
+#endif
     return true;
   }
 
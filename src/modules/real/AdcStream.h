@@ -0,0 +1,160 @@
+#pragma once
+
+/**
+ * @file AdcStream.h
+ * @brief 连续模式 ADC 采样引擎 - DMA 以固定采样率写入驱动环形缓冲
+ *
+ * 工作方式:
+ *   - start() 后 ADC 由硬件定时器按 sampleRateHz 触发，DMA 每满一帧
+ *     (AUDIO_DMA_FRAME_SAMPLES 个结果) 写入驱动内部环形缓冲
+ *   - read() 阻塞在驱动的信号量上等待数据，期间 CPU 空闲
+ *     （采样间隔不再依赖 delayMicroseconds，时间抖动由硬件决定）
+ *   - read() 按先进先出取出缓冲中最早的帧，而不是调用时刻最新的样本；
+ *     缓冲 (AUDIO_DMA_RING_FRAMES 帧) 写满后驱动丢弃新到的帧，
+ *     因此 start() 与首次 read() 间隔过长时，首个窗口是启动后最早的声音
+ *   - 采样衰减由 pattern.atten 配置，调用者不应再对该引脚调用 analogSetPinAttenuation()
+ *
+ * 兼容性:
+ *   - ESP-IDF 5.x: esp_adc/adc_continuous.h (Arduino-ESP32 3.x)
+ *   - ESP-IDF 4.4: driver/adc.h 中的 adc_digi_* (Arduino-ESP32 2.x)
+ *   - 仅支持 ADC1 单通道；结果格式 TYPE2（ESP32-S3）
+ */
+
+#include "../../../include/AppConfig.h"
+#include "esp_idf_version.h"
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include "esp_adc/adc_continuous.h"
+#else
+#include "driver/adc.h"
+#endif
+
+class AdcStream {
+private:
+  bool running = false;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  adc_continuous_handle_t handle = nullptr;
+#endif
+  uint8_t frame[AUDIO_DMA_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES];
+  uint8_t channel = 0;
+
+public:
+  ~AdcStream() { stop(); }
+
+  /**
+   * @brief 启动连续采样
+   * @param adc1Channel ADC1 通道号
+   * @param sampleRateHz 采样率 (SOC_ADC_SAMPLE_FREQ_THRES_LOW ~ HIGH)
+   */
+  bool start(uint8_t adc1Channel, uint32_t sampleRateHz) {
+    if (running) return true;
+    channel = adc1Channel;
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = adc1Channel;
+    pattern.unit = 0; // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    adc_continuous_handle_cfg_t handleCfg = {};
+    handleCfg.max_store_buf_size = sizeof(frame) * AUDIO_DMA_RING_FRAMES;
+    handleCfg.conv_frame_size = sizeof(frame);
+    if (adc_continuous_new_handle(&handleCfg, &handle) != ESP_OK) {
+      DEBUG_PRINTLN("[ADC-DMA] ❌ 驱动初始化失败");
+      return false;
+    }
+
+    adc_continuous_config_t digCfg = {};
+    digCfg.pattern_num = 1;
+    digCfg.adc_pattern = &pattern;
+    digCfg.sample_freq_hz = sampleRateHz;
+    digCfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digCfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_continuous_config(handle, &digCfg) != ESP_OK ||
+        adc_continuous_start(handle) != ESP_OK) {
+      DEBUG_PRINTLN("[ADC-DMA] ❌ 启动失败");
+      adc_continuous_deinit(handle);
+      handle = nullptr;
+      return false;
+    }
+#else
+    adc_digi_init_config_t initCfg = {};
+    initCfg.max_store_buf_size = sizeof(frame) * AUDIO_DMA_RING_FRAMES;
+    initCfg.conv_num_each_intr = sizeof(frame);
+    initCfg.adc1_chan_mask = BIT(adc1Channel);
+    initCfg.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&initCfg) != ESP_OK) {
+      DEBUG_PRINTLN("[ADC-DMA] ❌ 驱动初始化失败");
+      return false;
+    }
+
+    adc_digi_configuration_t digCfg = {};
+    digCfg.conv_limit_en = false;
+    digCfg.conv_limit_num = 250;
+    digCfg.pattern_num = 1;
+    digCfg.adc_pattern = &pattern;
+    digCfg.sample_freq_hz = sampleRateHz;
+    digCfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digCfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&digCfg) != ESP_OK || adc_digi_start() != ESP_OK) {
+      DEBUG_PRINTLN("[ADC-DMA] ❌ 启动失败");
+      adc_digi_deinitialize();
+      return false;
+    }
+#endif
+
+    running = true;
+    DEBUG_PRINTF("[ADC-DMA] ✓ 连续采样 %lu Hz (ADC1_CH%u)\n",
+                 (unsigned long)sampleRateHz, adc1Channel);
+    return true;
+  }
+
+  /**
+   * @brief 读取 count 个样本（12 位原始值），阻塞直到取满或超时
+   * @return 实际取得的样本数
+   */
+  size_t read(uint16_t *out, size_t count, uint32_t timeoutMs) {
+    if (!running) return 0;
+
+    size_t got = 0;
+    uint32_t start = millis();
+    while (got < count) {
+      uint32_t elapsed = millis() - start;
+      if (elapsed >= timeoutMs) break;
+
+      uint32_t bytes = 0;
+#if ESP_IDF_VERSION_MAJOR >= 5
+      esp_err_t err = adc_continuous_read(handle, frame, sizeof(frame), &bytes,
+                                          timeoutMs - elapsed);
+#else
+      esp_err_t err = adc_digi_read_bytes(frame, sizeof(frame), &bytes,
+                                          timeoutMs - elapsed);
+#endif
+      if (err != ESP_OK && bytes == 0) continue; // 超时或溢出后的空读
+
+      for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= bytes && got < count;
+           i += SOC_ADC_DIGI_RESULT_BYTES) {
+        adc_digi_output_data_t *p = (adc_digi_output_data_t *)&frame[i];
+        if (p->type2.channel != channel) continue;
+        out[got++] = p->type2.data;
+      }
+    }
+    return got;
+  }
+
+  void stop() {
+    if (!running) return;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    adc_continuous_stop(handle);
+    adc_continuous_deinit(handle);
+    handle = nullptr;
+#else
+    adc_digi_stop();
+    adc_digi_deinitialize();
+#endif
+    running = false;
+  }
+
+  bool isRunning() const { return running; }
+};
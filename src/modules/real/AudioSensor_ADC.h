@@ -3,44 +3,74 @@
 /**
  * @file AudioSensor_ADC.h
  * @brief 真实音频传感器实现 - 基于 ADC 模拟信号检测
+ *
+ * 采样方式:
+ *   - 默认使用连续模式 ADC (AdcStream)：DMA 以 AUDIO_SAMPLE_RATE_HZ 固定采样率
+ *     采集 AUDIO_WINDOW_SAMPLES 个样本，采样期间 CPU 空闲
+ *   - DMA 驱动不可用时退化为 analogRead() 轮询，按 micros() 对齐到同一采样率
+ *   - 最近一个窗口保留在 window[] 中，供后续声学分析使用
+ *
+ * 声级:
+ *   - 窗口交给 SoundLevelMeter：去直流 + A 计权 + RMS，得到 Leq / Lmax dB(A)
+ *   - 报警按 Leq 判定（与预计算的均方阈值做整数比较），单个尖峰不再触发报警
+ *   - 阈值在 init() 时取自适应基线 (NoiseFloor)，每次测量后用 Leq 更新基线
+ *   - 峰峰值仍然计算，仅用于调试输出和 getSoundPercent()
+ *   - classify() 对同一窗口做频谱分类（SoundClassifier），只在噪音超标时调用
+ *   - 每个窗口同时写入报警录音环形缓冲 (AudioClip)，captureClip() 补录触发后片段
  */
 
 #include "../../interfaces/IAudio.h"
 #include "../../../include/PinMap.h"
-#include <math.h>
+#include "../../utils/AudioClip.h"
+#include "../../utils/NoiseFloor.h"
+#include "../../utils/SoundClassifier.h"
+#include "../../utils/SoundLevelMeter.h"
+#include "AdcStream.h"
 
 class AudioSensor_ADC : public IAudio {
 private:
     uint16_t lastPeakToPeak;
     float lastDb;
     bool initialized;
+    AdcStream stream;
+    uint16_t window[AUDIO_WINDOW_SAMPLES]; // 最近一个采样窗口
+    size_t windowLen = 0;
+    SoundLevelMeter meter;
+    SoundLevel lastLevel;
+    float thresholdDb = NOISE_THRESHOLD_DB;
+#if ENABLE_SOUND_CLASSIFIER
+    SoundClassifier classifier;
+#endif
     
     /**
-     * @brief 将峰峰值转换为估算分贝（未校准）
+     * @brief 退化路径：analogRead() 轮询，按采样率对齐
      */
-    float peakToDb(uint16_t peak) {
-        if (peak <= 1) return 30.0f;
-        float db = 30.0f + 20.0f * log10((float)peak);
-        return constrain(db, 30.0f, 100.0f);
-    }
-    
-    /**
-     * @brief 将分贝阈值转换为峰峰值阈值
-     */
-    uint16_t dbToPeak(float db) {
-        // 反向计算: peak = 10^((db - 30) / 20)
-        float peak = pow(10.0f, (db - 30.0f) / 20.0f);
-        return (uint16_t)constrain(peak, 1.0f, 4095.0f);
+    size_t pollSamples(uint16_t *out, size_t count) {
+        const uint32_t periodUs = 1000000UL / AUDIO_SAMPLE_RATE_HZ;
+        uint32_t next = micros();
+        for (size_t i = 0; i < count; i++) {
+            while ((int32_t)(micros() - next) < 0) {}
+            out[i] = analogRead(PIN_MIC_ANALOG);
+            next += periodUs;
+        }
+        return count;
     }
     
 public:
     AudioSensor_ADC() : lastPeakToPeak(0), lastDb(30.0f), initialized(false) {}
     
     bool init() override {
-        // 配置 ADC 读取麦克风模拟信号
-        pinMode(PIN_MIC_ANALOG, INPUT);
-        analogReadResolution(12);
-        analogSetPinAttenuation(PIN_MIC_ANALOG, ADC_11db);
+        thresholdDb = NoiseFloor::thresholdDb();
+        meter.begin(AUDIO_SAMPLE_RATE_HZ, thresholdDb);
+
+        // 提前启动 DMA：首个窗口从此刻起按先进先出取出（含唤醒后最早的声音）
+        if (!stream.start(AUDIO_ADC_CHANNEL, AUDIO_SAMPLE_RATE_HZ)) {
+            // 退回单次读取（pollSamples）；连续模式的衰减由 AdcStream 配置，
+            // 不能在 DMA 运行时改写该引脚的单次模式设置
+            pinMode(PIN_MIC_ANALOG, INPUT);
+            analogReadResolution(12);
+            analogSetPinAttenuation(PIN_MIC_ANALOG, ADC_11db);
+        }
         
         initialized = true;
         return true;
@@ -48,37 +78,52 @@ public:
     
     uint16_t readPeakToPeak() override {
         if (!initialized) return 0;
+
+        windowLen = 0;
+        if (stream.isRunning()) {
+            windowLen = stream.read(window, AUDIO_WINDOW_SAMPLES, AUDIO_READ_TIMEOUT_MS);
+        }
+        if (windowLen == 0) {
+            windowLen = pollSamples(window, AUDIO_WINDOW_SAMPLES);
+        }
+        AudioClip::push(window, windowLen);
         
         uint16_t minVal = 4095;
         uint16_t maxVal = 0;
         uint32_t sum = 0;
         
-        for (int i = 0; i < NOISE_SAMPLE_COUNT; i++) {
-            uint16_t sample = analogRead(PIN_MIC_ANALOG);
+        for (size_t i = 0; i < windowLen; i++) {
+            uint16_t sample = window[i];
             sum += sample;
             if (sample > maxVal) maxVal = sample;
             if (sample < minVal) minVal = sample;
-            delayMicroseconds(NOISE_SAMPLE_INTERVAL_US);
         }
+        if (windowLen == 0) minVal = 0;
         
         // 调试：输出 ADC 原始值范围
-        uint16_t avg = sum / NOISE_SAMPLE_COUNT;
-        DEBUG_PRINTF("[Audio] ADC: min=%d, max=%d, avg=%d\n", minVal, maxVal, avg);
+        uint16_t avg = windowLen ? sum / windowLen : 0;
+        DEBUG_PRINTF("[Audio] ADC: min=%d, max=%d, avg=%d (%u 样本)\n", minVal, maxVal,
+                     avg, (unsigned)windowLen);
         
         lastPeakToPeak = maxVal - minVal;
-        lastDb = peakToDb(lastPeakToPeak);
+        lastLevel = meter.process(window, windowLen);
+        lastDb = constrain(lastLevel.leqDb, 30.0f, 100.0f);
+        DEBUG_PRINTF("[Audio] Leq=%.1f dB(A), Lmax=%.1f dB(A)\n", lastLevel.leqDb,
+                     lastLevel.lmaxDb);
+        if (lastLevel.leqSquare > 0) {
+            NoiseFloor::update(lastLevel.leqDb);
+        }
         return lastPeakToPeak;
     }
     
     /**
-     * @brief 检测是否有噪音（使用分贝阈值）
+     * @brief 检测是否有噪音（Leq 超过分贝阈值）
      */
     bool isNoiseDetected() override {
-        uint16_t threshold = dbToPeak(NOISE_THRESHOLD_DB);
-        bool detected = lastPeakToPeak > threshold;
+        bool detected = lastLevel.overThreshold;
         
         if (detected) {
-            DEBUG_PRINTF("[传感器] ⚠️ 噪音: %.0f dB > %d dB\n", lastDb, NOISE_THRESHOLD_DB);
+            DEBUG_PRINTF("[传感器] ⚠️ 噪音: %.0f dB > %.0f dB\n", lastDb, thresholdDb);
         }
         
         return detected;
@@ -89,7 +134,8 @@ public:
     }
     
     void sleep() override {
-        // 麦克风电路无需特殊休眠处理
+        // 麦克风电路无需特殊休眠处理，只停止 DMA 采样
+        stream.stop();
     }
     
     // ========== 扩展方法 ==========
@@ -101,20 +147,77 @@ public:
         return lastPeakToPeak;
     }
     
+    /**
+     * @brief 获取最近一个采样窗口（12 位原始值）
+     * @return 样本数
+     */
+    size_t getLastWindow(const uint16_t **samples) const {
+        *samples = window;
+        return windowLen;
+    }
+
     /**
      * @brief 获取上次测量的分贝值
      */
     float getLastDb() const {
         return lastDb;
     }
+
+    /**
+     * @brief 对最近一个窗口做频谱分类
+     */
+    SoundClass classify() {
+#if ENABLE_SOUND_CLASSIFIER
+        SpectralFeatures features;
+        if (classifier.extract(window, windowLen, AUDIO_SAMPLE_RATE_HZ, features)) {
+            return SoundClassifier::classify(features);
+        }
+#endif
+        return SOUND_UNKNOWN;
+    }
+
+    /**
+     * @brief 报警录音：继续采集触发后片段，然后冻结并编码
+     * @note 须在测量窗口之后立即调用：DMA 环形缓冲只有
+     *       AUDIO_DMA_RING_FRAMES × AUDIO_DMA_FRAME_SAMPLES 个样本，写满后新帧被丢弃。
+     *       按帧中转，window[] 保留触发窗口供随后的 classify() 使用
+     */
+    bool captureClip() {
+#if ENABLE_AUDIO_CLIP
+        if (!initialized) return false;
+        uint16_t chunk[AUDIO_DMA_FRAME_SAMPLES];
+        size_t remaining = (size_t)AUDIO_CLIP_POST_MS * AUDIO_SAMPLE_RATE_HZ / 1000;
+        size_t captured = 0;
+        while (remaining > 0) {
+            size_t want = min(remaining, (size_t)AUDIO_DMA_FRAME_SAMPLES);
+            size_t got = stream.isRunning()
+                             ? stream.read(chunk, want, AUDIO_READ_TIMEOUT_MS)
+                             : pollSamples(chunk, want);
+            if (got == 0) break;
+            AudioClip::push(chunk, got);
+            captured += got;
+            remaining -= got;
+        }
+        return AudioClip::freeze(captured);
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 获取上次测量的完整声级结果（Leq / Lmax）
+     */
+    const SoundLevel &getLastLevel() const {
+        return lastLevel;
+    }
     
     /**
      * @brief 打印当前状态
      */
     void printStatus() {
         uint16_t level = readPeakToPeak();
-        DEBUG_PRINTF("[Audio] 状态: %.0f dB (峰峰值=%d), 阈值=%d dB, %s\n",
-                     lastDb, level, NOISE_THRESHOLD_DB,
-                     lastDb > NOISE_THRESHOLD_DB ? "⚠️ 超标" : "✓ 正常");
+        DEBUG_PRINTF("[Audio] 状态: %.0f dB (峰峰值=%d), 阈值=%.0f dB, %s\n",
+                     lastDb, level, thresholdDb,
+                     lastDb > thresholdDb ? "⚠️ 超标" : "✓ 正常");
     }
 };
@@ -9,28 +9,71 @@
  *   2. 配置数据就绪中断（INT1_DRDY_XL）节省功耗
  *   3. ESP32-S3 侧计算倾斜角度，支持任意阈值（如 5°）
  *   4. 支持零点校准，计算相对于初始位置的角度变化
+ *   5. 快速启动 (ENABLE_FAST_BOOT)：IMU 在深度睡眠期间保持供电和配置，
+ *      缓存地址后只核对 WHO_AM_I / CTRL1_XL，跳过总线重置、延时和地址扫描
+ *   6. FIFO 批量采集 (ENABLE_IMU_FIFO)：FIFO 以连续模式在睡眠期间缓存加速度，
+ *      唤醒后按块突发读出最新 IMU_FIFO_MAX_SAMPLES 个样本，倾角取其均值
+ *   7. 倾斜中断 (ENABLE_TILT_INTERRUPT)：片上 wake-up 检测经 INT1 → PIN_LSM_INT1，
+ *      作为 EXT1 深度睡眠唤醒源；阈值由 TILT_THRESHOLD 换算（见 wakeThresholdCode()）
+ *   8. 陀螺仪融合 (ENABLE_TILT_FUSION)：陀螺仪平时关闭，读倾角时临时以 104 Hz 开启，
+ *      与加速度计做互补滤波（TiltFusion.h），零偏在首次校准时测定并存于 RTC
  *
  * 工作原理:
  *   - 加速度计以 26 Hz 采样（38.5 ms/次）
  *   - 每次数据准备好时，INT1 拉高触发中断
- *   - ESP32 读取 X/Y/Z 轴数据，用 atan2 计算角度
+ *   - ESP32 一次突发读取 X/Y/Z 六个字节（或整块 FIFO），用 atan2 计算角度
  *   - 对比初始角度，判断是否超过设定阈值（如 5°）
  *
- * @note 使用 SparkFun LSM6DS3 库
+ * @note SparkFun 库只用于 begin()；数据读取直接访问寄存器，
+ *       量程按 CTRL1_XL_CONFIG (±2g) 换算，不依赖库内部的量程设置
  */
 
 #include "../../../include/AppConfig.h"
 #include "../../../include/PinMap.h"
 #include "../../interfaces/ISensor.h"
+#include "../../utils/TiltFusion.h"
 #include <SparkFunLSM6DS3.h>
 #include <Wire.h>
 
 // LSM6DS3 关键寄存器地址
+#define LSM6DS3_WHO_AM_I 0x0F   // 器件 ID (LSM6DS3=0x69, LSM6DS3TR-C=0x6A)
 #define LSM6DS3_CTRL1_XL 0x10   // 加速度计控制寄存器
+#define LSM6DS3_CTRL2_G 0x11    // 陀螺仪控制寄存器
+#define LSM6DS3_OUTX_L_G 0x22   // 陀螺仪 X/Y/Z 后紧跟加速度 X/Y/Z（连续 12 字节）
 #define LSM6DS3_STATUS_REG 0x1E // 状态寄存器（数据就绪标志）
+#define LSM6DS3_OUTX_L_XL 0x28  // 加速度输出 X/Y/Z（低字节在前，连续 6 字节）
+#define LSM6DS3_FIFO_CTRL3 0x08 // FIFO 抽取设置（哪些数据进入 FIFO）
+#define LSM6DS3_FIFO_CTRL5 0x0A // FIFO 速率与模式
+#define LSM6DS3_FIFO_STATUS1 0x3A // FIFO 未读字数 / 标志 / 模式位置（连续 4 字节）
+#define LSM6DS3_FIFO_DATA_OUT_L 0x3E // FIFO 输出（突发读时地址自动回绕）
+#define LSM6DS3_TAP_CFG 0x58     // 中断使能 / 斜率滤波选择
+#define LSM6DS3_WAKE_UP_THS 0x5B // wake-up 阈值 [5:0]，1 LSB = 量程/64
+#define LSM6DS3_WAKE_UP_DUR 0x5C // wake-up 持续时间 [6:5]（ODR 周期）
+#define LSM6DS3_MD1_CFG 0x5E     // INT1 功能路由
+
+#define LSM6DS3_CTRL1_XL_CONFIG 0x20 // 26 Hz, ±2g
+#define LSM6DS3_ACCEL_G_PER_LSB 0.000061f // ±2g 灵敏度 0.061 mg/LSB
+#define LSM6DS3_CTRL1_XL_FUSION 0x40 // 融合窗口内: 104 Hz, ±2g
+#define LSM6DS3_CTRL2_G_FUSION 0x40  // 融合窗口内: 104 Hz, ±245 dps
+#define LSM6DS3_GYRO_DPS_PER_LSB 0.00875f // ±245 dps 灵敏度 8.75 mdps/LSB
+
+#define LSM6DS3_FIFO_CTRL3_CONFIG 0x01 // 加速度不抽取，陀螺仪不进入 FIFO
+#define LSM6DS3_FIFO_CTRL5_CONFIG ((IMU_FIFO_ODR_CODE << 3) | 0x06) // 连续模式
+#define LSM6DS3_FIFO_CHUNK_SAMPLES 20 // 每次突发读取样本数（120 字节 < Wire 缓冲）
+
+#define LSM6DS3_TAP_CFG_CONFIG 0x90 // 中断使能 + 斜率滤波，非锁存（事件结束 INT1 自动复位）
+#define LSM6DS3_WAKE_UP_DUR_CONFIG 0x20 // 持续 1 个 ODR 周期才触发，滤除单点毛刺
+#define LSM6DS3_MD1_INT1_WU 0x20    // wake-up 事件输出到 INT1
+
+// RTC 缓存：上次发现的 IMU 地址（0=未知，需完整初始化）
+RTC_DATA_ATTR uint8_t g_imuCachedAddr = 0;
+
+// RTC 缓存：陀螺仪零偏 (°/s)，首次启动校准时测定
+RTC_DATA_ATTR float g_gyroBiasDps[3] = {0.0f, 0.0f, 0.0f};
 
 // 寄存器位掩码
 #define XLDA_BIT 0x01 // STATUS_REG[0]: 加速度数据就绪标志
+#define GDA_BIT 0x02  // STATUS_REG[1]: 陀螺仪数据就绪标志
 
 class LSM6DS3_Sensor : public ISensor {
 private:
@@ -41,6 +84,12 @@ private:
   float initialPitch = 0.0f;
   float initialRoll = 0.0f;
 
+#if ENABLE_IMU_FIFO
+  int16_t fifo[IMU_FIFO_MAX_SAMPLES][3]; // 环形存放，fifoStart 为最早样本
+  size_t fifoCount = 0;
+  size_t fifoStart = 0;
+#endif
+
   /**
    * @brief 写寄存器（I2C）
    */
@@ -64,12 +113,232 @@ private:
     return Wire.read();
   }
 
+  /**
+   * @brief 从 reg 开始突发读取 len 字节（单次 I2C 事务，寄存器地址自动递增）
+   */
+  bool readBurst(uint8_t reg, uint8_t *buf, size_t len) {
+    Wire.beginTransmission(deviceAddr);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom(deviceAddr, (uint8_t)len) != len) return false;
+    for (size_t i = 0; i < len; i++) buf[i] = Wire.read();
+    return true;
+  }
+
+  static void unpackAccel(const uint8_t *buf, int16_t out[3]) {
+    for (int axis = 0; axis < 3; axis++) {
+      out[axis] = (int16_t)(buf[axis * 2] | (buf[axis * 2 + 1] << 8));
+    }
+  }
+
+  /**
+   * @brief 写入加速度计和 FIFO 配置
+   */
+  void configureRegisters() {
+    writeRegister(LSM6DS3_CTRL1_XL, LSM6DS3_CTRL1_XL_CONFIG);
+#if ENABLE_TILT_FUSION
+    writeRegister(LSM6DS3_CTRL2_G, 0x00); // 陀螺仪掉电，只在融合窗口内开启
+#endif
+#if ENABLE_IMU_FIFO
+    writeRegister(LSM6DS3_FIFO_CTRL3, LSM6DS3_FIFO_CTRL3_CONFIG);
+    writeRegister(LSM6DS3_FIFO_CTRL5, LSM6DS3_FIFO_CTRL5_CONFIG);
+#endif
+#if ENABLE_TILT_INTERRUPT
+    writeRegister(LSM6DS3_TAP_CFG, LSM6DS3_TAP_CFG_CONFIG);
+    writeRegister(LSM6DS3_WAKE_UP_THS, wakeThresholdCode());
+    writeRegister(LSM6DS3_WAKE_UP_DUR, LSM6DS3_WAKE_UP_DUR_CONFIG);
+    writeRegister(LSM6DS3_MD1_CFG, LSM6DS3_MD1_INT1_WU);
+#endif
+  }
+
+  /**
+   * @brief TILT_THRESHOLD → wake-up 阈值码
+   *
+   * 杆体从静止倾斜 θ 时，重力向量变化 |Δa| = 2·sin(θ/2) g；按 ±2g 量程
+   * 1 LSB = 31.25 mg 向下取整（至少 1），宁可多唤醒，由主 CPU 复核角度
+   */
+  static uint8_t wakeThresholdCode() {
+    float deltaG = 2.0f * sinf(TILT_THRESHOLD * 0.5f * PI / 180.0f);
+    int code = (int)(deltaG / (2.0f / 64.0f));
+    return (uint8_t)constrain(code, 1, 63);
+  }
+
+  /**
+   * @brief IMU 是否保留了本驱动的配置（掉电后恢复默认值）
+   */
+  bool isConfigured() {
+    if (readRegister(LSM6DS3_CTRL1_XL) != LSM6DS3_CTRL1_XL_CONFIG) return false;
+#if ENABLE_IMU_FIFO
+    if (readRegister(LSM6DS3_FIFO_CTRL5) != LSM6DS3_FIFO_CTRL5_CONFIG) return false;
+#endif
+#if ENABLE_TILT_INTERRUPT
+    if (readRegister(LSM6DS3_MD1_CFG) != LSM6DS3_MD1_INT1_WU) return false;
+#endif
+    return true;
+  }
+
+  /**
+   * @brief 单次突发读取当前加速度 (g)
+   */
+  bool readAccel(float &ax, float &ay, float &az) {
+    uint8_t buf[6];
+    if (!readBurst(LSM6DS3_OUTX_L_XL, buf, sizeof(buf))) return false;
+    int16_t raw[3];
+    unpackAccel(buf, raw);
+    ax = raw[0] * LSM6DS3_ACCEL_G_PER_LSB;
+    ay = raw[1] * LSM6DS3_ACCEL_G_PER_LSB;
+    az = raw[2] * LSM6DS3_ACCEL_G_PER_LSB;
+    return true;
+  }
+
+  /**
+   * @brief 读取用于计算倾角的加速度：FIFO 样本足够时取均值，否则读输出寄存器
+   * @param newest 只平均最新的若干个样本（0=全部保留样本）
+   */
+  bool readAccelFiltered(float &ax, float &ay, float &az, size_t newest = 0) {
+#if ENABLE_IMU_FIFO
+    if (drainFifo() >= IMU_FIFO_MIN_SAMPLES) {
+      size_t first = (newest > 0 && newest < fifoCount) ? fifoCount - newest : 0;
+      int32_t sum[3] = {0, 0, 0};
+      for (size_t i = first; i < fifoCount; i++) {
+        const int16_t *s = getFifoSample(i);
+        for (int axis = 0; axis < 3; axis++) sum[axis] += s[axis];
+      }
+      float scale = LSM6DS3_ACCEL_G_PER_LSB / (fifoCount - first);
+      ax = sum[0] * scale;
+      ay = sum[1] * scale;
+      az = sum[2] * scale;
+      return true;
+    }
+#endif
+    return readAccel(ax, ay, az);
+  }
+
+  static void anglesFrom(float ax, float ay, float az, float &pitch, float &roll) {
+    pitch = atan2(ax, sqrt(ay * ay + az * az)) * 180.0 / PI;
+    roll = atan2(ay, sqrt(ax * ax + az * az)) * 180.0 / PI;
+  }
+
+  /**
+   * @brief 相对于初始位置的最大偏移角，数据无效返回 -1
+   */
+  float relativeTilt(bool ok, float ax, float ay, float az) {
+    // 数据有效性检查（全零表示读取失败）
+    if (!ok || (ax == 0.0f && ay == 0.0f && az == 0.0f)) {
+      DEBUG_PRINTLN("[传感器] ⚠️ IMU 数据异常");
+      return -1.0f;
+    }
+
+    // 计算当前 Pitch 和 Roll 角度
+    float currentPitch, currentRoll;
+    anglesFrom(ax, ay, az, currentPitch, currentRoll);
+    return relativeAngle(currentPitch, currentRoll);
+  }
+
+  float relativeAngle(float currentPitch, float currentRoll) {
+    // 计算相对于初始位置的偏移量
+    float deltaPitch = abs(currentPitch - initialPitch);
+    float deltaRoll = abs(currentRoll - initialRoll);
+
+    // 返回最大偏移量
+    float maxTilt = max(deltaPitch, deltaRoll);
+    return maxTilt;
+  }
+
+#if ENABLE_TILT_FUSION
+  /**
+   * @brief 开启陀螺仪并把加速度计提到同样的 104 Hz，等待陀螺仪稳定
+   */
+  bool startGyro() {
+    if (!writeRegister(LSM6DS3_CTRL1_XL, LSM6DS3_CTRL1_XL_FUSION)) return false;
+    if (!writeRegister(LSM6DS3_CTRL2_G, LSM6DS3_CTRL2_G_FUSION)) return false;
+    delay(IMU_GYRO_SETTLE_MS);
+    return true;
+  }
+
+  /**
+   * @brief 关闭陀螺仪，恢复睡眠期间的加速度计配置
+   */
+  void stopGyro() {
+    writeRegister(LSM6DS3_CTRL2_G, 0x00);
+    writeRegister(LSM6DS3_CTRL1_XL, LSM6DS3_CTRL1_XL_CONFIG);
+  }
+
+  /**
+   * @brief 等待新的陀螺仪样本，一次突发读取陀螺仪 + 加速度（12 字节）
+   * @param g 角速度 (°/s)
+   * @param a 加速度 (g)
+   * @param removeBias 是否扣除 RTC 中的零偏
+   */
+  bool readGyroAccel(float g[3], float a[3], bool removeBias = true) {
+    uint32_t start = millis();
+    while (!(readRegister(LSM6DS3_STATUS_REG) & GDA_BIT)) {
+      if (millis() - start > IMU_READY_TIMEOUT_MS) return false;
+    }
+    uint8_t buf[12];
+    if (!readBurst(LSM6DS3_OUTX_L_G, buf, sizeof(buf))) return false;
+
+    int16_t rawG[3], rawA[3];
+    unpackAccel(buf, rawG);
+    unpackAccel(buf + 6, rawA);
+    for (int axis = 0; axis < 3; axis++) {
+      g[axis] = rawG[axis] * LSM6DS3_GYRO_DPS_PER_LSB;
+      if (removeBias) g[axis] -= g_gyroBiasDps[axis];
+      a[axis] = rawA[axis] * LSM6DS3_ACCEL_G_PER_LSB;
+    }
+    return true;
+  }
+#endif
+
+  /**
+   * @brief 快速初始化：使用缓存地址，轮询就绪代替固定延时
+   * @return false=需走完整初始化
+   */
+  bool initFast() {
+    if (!Wire.begin(PIN_LSM_SDA, PIN_LSM_SCL, IMU_I2C_HZ)) {
+      return false;
+    }
+    deviceAddr = g_imuCachedAddr;
+
+    uint32_t start = millis();
+    uint8_t id = readRegister(LSM6DS3_WHO_AM_I);
+    while (id != 0x69 && id != 0x6A) {
+      if (millis() - start > IMU_READY_TIMEOUT_MS) {
+        g_imuCachedAddr = 0;
+        return false;
+      }
+      delay(1);
+      id = readRegister(LSM6DS3_WHO_AM_I);
+    }
+
+    // 仅在 IMU 掉电丢失配置时重新配置
+    if (!isConfigured()) {
+      if (imu.begin() != 0) {
+        return false;
+      }
+      configureRegisters();
+    }
+
+    while (!isDataReady() && millis() - start < IMU_READY_TIMEOUT_MS) {
+      delay(1);
+    }
+
+    DEBUG_PRINTF("[传感器] ✓ IMU 就绪 (缓存地址 0x%02X, %lu ms)\n", deviceAddr,
+                 millis() - start);
+    return true;
+  }
+
 public:
   bool init() override {
+#if ENABLE_FAST_BOOT
+    if (g_imuCachedAddr != 0 && initFast()) {
+      return true;
+    }
+#endif
     Wire.end();
     delay(10);
     
-    if (!Wire.begin(PIN_LSM_SDA, PIN_LSM_SCL, 100000)) {
+    if (!Wire.begin(PIN_LSM_SDA, PIN_LSM_SCL, IMU_I2C_HZ)) {
       DEBUG_PRINTLN("[传感器] ❌ I2C 初始化失败");
       return false;
     }
@@ -95,7 +364,8 @@ public:
       return false;
     }
 
-    writeRegister(LSM6DS3_CTRL1_XL, 0x20);
+    configureRegisters();
+    g_imuCachedAddr = deviceAddr;
     
     DEBUG_PRINTLN("[传感器] ✓ IMU 就绪");
     return true;
@@ -114,50 +384,190 @@ public:
    * @return 相对倾斜角度（绝对值），读取失败返回 -1
    */
   float readData() override {
-    // 读取加速度计数据（使用 SparkFun 库）
-    float ax = imu.readFloatAccelX();
-    float ay = imu.readFloatAccelY();
-    float az = imu.readFloatAccelZ();
-    
-    // 数据有效性检查（全零表示读取失败）
-    if (ax == 0.0f && ay == 0.0f && az == 0.0f) {
-      DEBUG_PRINTLN("[传感器] ⚠️ IMU 数据异常");
-      return -1.0f;
+    float ax, ay, az;
+    bool ok = readAccelFiltered(ax, ay, az);
+    return relativeTilt(ok, ax, ay, az);
+  }
+
+  /**
+   * @brief 只读输出寄存器的瞬时倾角（不经 FIFO 均值）
+   *
+   * 中断唤醒时 FIFO 里大部分是事件之前的样本，均值会掩盖刚发生的倾斜，
+   * 此时改用瞬时值并由调用者多次采样防抖
+   */
+  float readInstantTilt() {
+    float ax, ay, az;
+    bool ok = readAccel(ax, ay, az);
+    return relativeTilt(ok, ax, ay, az);
+  }
+
+#if ENABLE_TILT_FUSION
+  /**
+   * @brief 陀螺仪融合后的倾角（相对于初始位置）
+   *
+   * 在 TILT_DEBOUNCE_COUNT × TILT_SAMPLE_INTERVAL_MS 的窗口内以 104 Hz 做互补滤波，
+   * 每 TILT_SAMPLE_INTERVAL_MS 取一次检查点，返回各检查点的最小值：
+   * 只有整个窗口内都超过阈值才会报警
+   *
+   * 初值取 FIFO 均值（风摆在长窗口内平均掉），窗口内陀螺仪跟踪真实转动，
+   * 加速度计只做缓慢修正
+   *
+   * @param recentOnly true=中断唤醒：只平均最新 TILT_FUSION_SEED_SAMPLES 个样本，
+   *                   FIFO 中更早的样本在事件之前
+   * @return 相对倾角，失败返回 -1
+   */
+  float readFusedTilt(bool recentOnly) {
+    float ax, ay, az;
+    bool ok = readAccelFiltered(ax, ay, az, recentOnly ? TILT_FUSION_SEED_SAMPLES : 0);
+    if (relativeTilt(ok, ax, ay, az) < 0) return -1.0f;
+
+    float pitch, roll;
+    anglesFrom(ax, ay, az, pitch, roll);
+    TiltFusion fusion;
+    fusion.reset(pitch, roll);
+
+    if (!startGyro()) {
+      stopGyro();
+      return relativeAngle(pitch, roll);
     }
 
-    // 计算当前 Pitch 和 Roll 角度
-    float currentPitch = atan2(ax, sqrt(ay * ay + az * az)) * 180.0 / PI;
-    float currentRoll = atan2(ay, sqrt(ax * ax + az * az)) * 180.0 / PI;
+    float minTilt = -1.0f;
+    int checks = 0;
+    uint32_t lastUs = micros();
+    uint32_t nextCheck = millis() + TILT_SAMPLE_INTERVAL_MS;
+    uint32_t deadline = millis() + TILT_DEBOUNCE_COUNT * TILT_SAMPLE_INTERVAL_MS * 2;
+    while (checks < TILT_DEBOUNCE_COUNT && millis() < deadline) {
+      float g[3], a[3];
+      if (!readGyroAccel(g, a)) continue;
+      uint32_t nowUs = micros();
+      fusion.update(a[0], a[1], a[2], g[0], g[1], (nowUs - lastUs) * 1e-6f);
+      lastUs = nowUs;
 
-    // 计算相对于初始位置的偏移量
-    float deltaPitch = abs(currentPitch - initialPitch);
-    float deltaRoll = abs(currentRoll - initialRoll);
+      if ((int32_t)(millis() - nextCheck) >= 0) {
+        float tilt = relativeAngle(fusion.getPitch(), fusion.getRoll());
+        minTilt = (minTilt < 0) ? tilt : min(minTilt, tilt);
+        checks++;
+        nextCheck += TILT_SAMPLE_INTERVAL_MS;
+      }
+    }
+    stopGyro();
 
-    // 返回最大偏移量
-    float maxTilt = max(deltaPitch, deltaRoll);
-    return maxTilt;
+    if (checks == 0) return relativeAngle(pitch, roll);
+    DEBUG_PRINTF("[传感器] 融合倾角 %.2f° (加速度计 %.2f°, %d 个检查点)\n", minTilt,
+                 relativeAngle(pitch, roll), checks);
+    return minTilt;
   }
 
   /**
-   * @brief 获取绝对 Pitch 角度（不考虑校准）
+   * @brief 测定陀螺仪零偏（须在杆体静止时调用，如首次启动校准）
    */
-  float getAbsolutePitch() {
-    float ax = imu.readFloatAccelX();
-    float ay = imu.readFloatAccelY();
-    float az = imu.readFloatAccelZ();
-    return atan2(ax, sqrt(ay * ay + az * az)) * 180.0 / PI;
+  bool calibrateGyroBias() {
+    if (!startGyro()) {
+      stopGyro();
+      return false;
+    }
+    float sum[3] = {0.0f, 0.0f, 0.0f};
+    int n = 0;
+    uint32_t deadline = millis() + IMU_GYRO_BIAS_SAMPLES * 20;
+    while (n < IMU_GYRO_BIAS_SAMPLES && millis() < deadline) {
+      float g[3], a[3];
+      if (!readGyroAccel(g, a, false)) continue;
+      for (int axis = 0; axis < 3; axis++) sum[axis] += g[axis];
+      n++;
+    }
+    stopGyro();
+    if (n == 0) return false;
+
+    for (int axis = 0; axis < 3; axis++) g_gyroBiasDps[axis] = sum[axis] / n;
+    DEBUG_PRINTF("[传感器] ✓ 陀螺仪零偏 %.2f / %.2f / %.2f °/s\n", g_gyroBiasDps[0],
+                 g_gyroBiasDps[1], g_gyroBiasDps[2]);
+    return true;
   }
+#endif
 
   /**
-   * @brief 获取绝对 Roll 角度（不考虑校准）
+   * @brief 获取绝对 Pitch / Roll 角度（不考虑校准，一次读取）
+   * @return false=读取失败
    */
-  float getAbsoluteRoll() {
-    float ax = imu.readFloatAccelX();
-    float ay = imu.readFloatAccelY();
-    float az = imu.readFloatAccelZ();
-    return atan2(ay, sqrt(ax * ax + az * az)) * 180.0 / PI;
+  bool readPose(float &pitch, float &roll) {
+    float ax, ay, az;
+    if (!readAccelFiltered(ax, ay, az)) return false;
+    anglesFrom(ax, ay, az, pitch, roll);
+    return true;
   }
 
+  /**
+   * @brief 读取三轴原始加速度（供唤醒桩记录参考向量）
+   */
+  void readRawAccel(int16_t out[3]) {
+    uint8_t buf[6];
+    if (readBurst(LSM6DS3_OUTX_L_XL, buf, sizeof(buf))) {
+      unpackAccel(buf, out);
+    } else {
+      out[0] = out[1] = out[2] = 0;
+    }
+  }
+
+#if ENABLE_IMU_FIFO
+  /**
+   * @brief 排空 FIFO，保留最新 IMU_FIFO_MAX_SAMPLES 个样本
+   * @return 保留的样本数（按时间顺序用 getFifoSample() 访问）
+   */
+  size_t drainFifo() {
+    fifoCount = 0;
+    fifoStart = 0;
+
+    uint8_t status[4];
+    if (!readBurst(LSM6DS3_FIFO_STATUS1, status, sizeof(status))) return 0;
+    size_t words = status[0] | ((status[1] & 0x0F) << 8);
+    uint16_t pattern = status[2] | ((status[3] & 0x03) << 8);
+
+    // 连续模式溢出后读指针可能停在样本中间，先丢弃到下一个 X 轴
+    size_t skip = pattern ? 3 - pattern : 0;
+    if (words < skip + 3) return 0;
+
+    uint32_t prevClock = Wire.getClock(); // 总线与其他器件共用，结束后原样恢复
+    Wire.setClock(IMU_I2C_BURST_HZ);
+    uint8_t buf[LSM6DS3_FIFO_CHUNK_SAMPLES * 6];
+    if (skip > 0 && !readBurst(LSM6DS3_FIFO_DATA_OUT_L, buf, skip * 2)) {
+      Wire.setClock(prevClock);
+      return 0;
+    }
+
+    size_t total = (words - skip) / 3;
+    size_t n = 0;
+    while (n < total) {
+      size_t batch = total - n;
+      if (batch > LSM6DS3_FIFO_CHUNK_SAMPLES) batch = LSM6DS3_FIFO_CHUNK_SAMPLES;
+      if (!readBurst(LSM6DS3_FIFO_DATA_OUT_L, buf, batch * 6)) break;
+      for (size_t k = 0; k < batch; k++, n++) {
+        unpackAccel(&buf[k * 6], fifo[n % IMU_FIFO_MAX_SAMPLES]);
+      }
+    }
+    Wire.setClock(prevClock);
+
+    if (n > IMU_FIFO_MAX_SAMPLES) {
+      fifoCount = IMU_FIFO_MAX_SAMPLES;
+      fifoStart = n % IMU_FIFO_MAX_SAMPLES;
+    } else {
+      fifoCount = n;
+    }
+    DEBUG_PRINTF("[传感器] FIFO 读出 %u 样本，保留 %u\n", (unsigned)n, (unsigned)fifoCount);
+    return fifoCount;
+  }
+
+  size_t getFifoCount() const { return fifoCount; }
+
+  /**
+   * @brief 第 i 个保留样本（0 为最早），三轴原始值
+   */
+  const int16_t *getFifoSample(size_t i) const {
+    return fifo[(fifoStart + i) % IMU_FIFO_MAX_SAMPLES];
+  }
+#endif
+
+  uint8_t getAddress() const { return deviceAddr; }
+
   /**
    * @brief 检查数据是否就绪
    */
@@ -23,17 +23,71 @@
  *   - 使用 heap_caps_malloc(MALLOC_CAP_SPIRAM) 在 PSRAM 中分配缓冲区
  *   - 图片数据存储在 PSRAM 中，避免占用宝贵的 SRAM
  *   - 支持 ESP32-S3-WROOM-1-N8R2 的 2MB PSRAM
+ *
+ * 曝光状态保持 (ENABLE_CAM_AE_CACHE):
+ *   - 每次拍照成功后读回已收敛的曝光 (AEC) 和增益 (AGC)，存入 RTC 内存
+ *   - 下次初始化时若记录未超过 CAM_AE_CACHE_MAX_AGE_SEC，直接写回寄存器作为
+ *     自动曝光的起点，只丢弃一帧（代替 200ms + 5 帧预热）
+ *   - 拍照后 AEC 与写回值偏差超过 CAM_AE_CACHE_MAX_DRIFT_PCT（场景明暗已变）时，
+ *     补做预热并重拍
+ *   - 自动曝光/增益/白平衡始终保持开启，写回值只是收敛起点
+ *
+ * 连拍选优 (ENABLE_CAM_BURST):
+ *   - 连拍 CAM_BURST_FRAMES 帧，每帧按 CAM_BURST_SCORE_SCALE 降采样解码为灰度图，
+ *     以扣除噪声贡献的拉普拉斯方差评分（Sharpness::score），只保留得分最高的一帧
+ *   - 帧池为 CAM_BURST_FB_COUNT 个 PSRAM 帧缓冲: 持有当前最优帧的同时驱动
+ *     向另一缓冲采集下一帧，无需拷贝 JPEG
+ *
+ * 字节预算码率控制 (ENABLE_CAM_RATE_CONTROL):
+ *   - 上次照片的大小和 JPEG 质量存 RTC 内存
+ *   - OV2640 量化系数与质量值成正比，JPEG 大小近似与之成反比，因此
+ *       本次质量 = 上次质量 × 上次大小 / 预算
+ *     偏差在 ±CAM_RATE_DEADBAND_PCT 内不调整，单次最多调整 CAM_RATE_MAX_STEP，
+ *     并限制在 [CAM_JPEG_QUALITY_MIN, CAM_JPEG_QUALITY_MAX]
+ *   - 预算由调用者按电量给出（setByteBudget），大小决定上传时长即射频开启时间
  */
 
 #include "../../../include/AppConfig.h"
 #include "../../../include/PinMap.h"
 #include "../../interfaces/ICamera.h"
+#include "../../utils/JpegGray.h"
+#include "../../utils/RtcClock.h"
+#include "../../utils/Sharpness.h"
 
 #if ENABLE_CAMERA
 #include "esp_camera.h"
 #include "esp_heap_caps.h" // PSRAM 内存管理
 #endif
 
+// OV2640 传感器寄存器（esp32-camera get_reg/set_reg 以 0x100 位选择 sensor bank）
+#define OV2640_REG_GAIN 0x100  // AGC[7:0]
+#define OV2640_REG_REG04 0x104 // [1:0] AEC[1:0]
+#define OV2640_REG_AEC 0x110   // AEC[9:2]
+#define OV2640_REG_REG45 0x145 // [7:6] AGC[9:8], [5:0] AEC[15:10]
+
+/**
+ * @brief 上次收敛的曝光状态（RTC 内存，深度睡眠保持）
+ */
+struct CameraAeState {
+  uint32_t magic;
+  uint32_t savedAt; // RTC 秒
+  uint16_t aec;     // 曝光行数
+  uint16_t agc;     // 增益
+};
+
+RTC_DATA_ATTR CameraAeState g_camAeState = {};
+
+/**
+ * @brief 上次照片的码率记录（RTC 内存，深度睡眠保持）
+ */
+struct CameraRateState {
+  uint32_t magic;
+  uint32_t lastSize; // 上次照片大小 (bytes)
+  uint8_t quality;   // 上次使用的 JPEG 质量
+};
+
+RTC_DATA_ATTR CameraRateState g_camRateState = {};
+
 class OV2640_Camera : public ICamera {
 private:
   bool initialized = false;
@@ -43,6 +97,136 @@ private:
   // 简化: 直接保存帧缓冲指针 (参考 project-name/main/camera_module.c)
   camera_fb_t *currentFrame = nullptr;
 
+  bool aeRestored = false; // 本次初始化写回了缓存的曝光状态
+
+  size_t byteBudget = CAM_JPEG_BUDGET_BYTES;
+  int jpegQuality = CAM_JPEG_QUALITY;
+
+  static const uint32_t AE_MAGIC = 0x41454341;   // "AECA"
+  static const uint32_t RATE_MAGIC = 0x52415445; // "RATE"
+
+  /**
+   * @brief 按上次照片大小选择本次 JPEG 质量
+   */
+  int chooseQuality() const {
+    if (!ENABLE_CAM_RATE_CONTROL || g_camRateState.magic != RATE_MAGIC ||
+        g_camRateState.lastSize == 0 || byteBudget == 0) {
+      return CAM_JPEG_QUALITY;
+    }
+
+    int last = g_camRateState.quality;
+    float ratio = (float)g_camRateState.lastSize / byteBudget;
+    if (fabsf(ratio - 1.0f) * 100.0f <= CAM_RATE_DEADBAND_PCT) return last;
+
+    int target = (int)lroundf(last * ratio);
+    target = constrain(target, last - CAM_RATE_MAX_STEP, last + CAM_RATE_MAX_STEP);
+    return constrain(target, CAM_JPEG_QUALITY_MIN, CAM_JPEG_QUALITY_MAX);
+  }
+
+#if ENABLE_CAMERA
+  /**
+   * @brief 丢弃预热帧，等待自动曝光稳定
+   */
+  static void discardWarmupFrames() {
+#if ENABLE_FAST_BOOT
+    // esp_camera_fb_get() 阻塞到下一帧就绪，无需额外延时
+    for (int i = 0; i < CAM_FAST_BOOT_WARMUP_FRAMES; i++) {
+      camera_fb_t *fb = esp_camera_fb_get();
+      if (fb) esp_camera_fb_return(fb);
+    }
+#else
+    delay(200);
+    for (int i = 0; i < 5; i++) {
+      camera_fb_t *fb = esp_camera_fb_get();
+      if (fb) esp_camera_fb_return(fb);
+      delay(50);
+    }
+#endif
+  }
+
+  static bool readAe(sensor_t *s, uint16_t &aec, uint16_t &agc) {
+    int reg04 = s->get_reg(s, OV2640_REG_REG04, 0x03);
+    int aecMid = s->get_reg(s, OV2640_REG_AEC, 0xFF);
+    int reg45 = s->get_reg(s, OV2640_REG_REG45, 0xFF);
+    int gain = s->get_reg(s, OV2640_REG_GAIN, 0xFF);
+    if (reg04 < 0 || aecMid < 0 || reg45 < 0 || gain < 0) return false;
+    aec = ((reg45 & 0x3F) << 10) | (aecMid << 2) | reg04;
+    agc = ((reg45 >> 6) << 8) | gain;
+    return true;
+  }
+
+  static void writeAe(sensor_t *s, uint16_t aec, uint16_t agc) {
+    s->set_reg(s, OV2640_REG_REG04, 0x03, aec & 0x03);
+    s->set_reg(s, OV2640_REG_AEC, 0xFF, (aec >> 2) & 0xFF);
+    s->set_reg(s, OV2640_REG_REG45, 0xFF, ((agc >> 8) & 0x03) << 6 | ((aec >> 10) & 0x3F));
+    s->set_reg(s, OV2640_REG_GAIN, 0xFF, agc & 0xFF);
+  }
+
+  static bool isAeCacheFresh() {
+    return ENABLE_CAM_AE_CACHE && g_camAeState.magic == AE_MAGIC &&
+           rtcNowSeconds() - g_camAeState.savedAt <= CAM_AE_CACHE_MAX_AGE_SEC;
+  }
+
+  /**
+   * @brief 拍照成功后记录收敛状态
+   * @return false=本帧以写回值曝光，但自动曝光随即大幅调整（场景已变），应重拍
+   */
+  bool saveAe() {
+    sensor_t *s = esp_camera_sensor_get();
+    uint16_t aec, agc;
+    if (!ENABLE_CAM_AE_CACHE || !s || !readAe(s, aec, agc)) return true;
+
+    bool consistent = true;
+    if (aeRestored) {
+      uint16_t ref = g_camAeState.aec > 0 ? g_camAeState.aec : 1;
+      uint32_t drift = (uint32_t)abs((int)aec - (int)g_camAeState.aec) * 100 / ref;
+      consistent = drift <= CAM_AE_CACHE_MAX_DRIFT_PCT;
+      aeRestored = false;
+    }
+
+    g_camAeState.magic = AE_MAGIC;
+    g_camAeState.savedAt = rtcNowSeconds();
+    g_camAeState.aec = aec;
+    g_camAeState.agc = agc;
+    return consistent;
+  }
+
+  /**
+   * @brief 帧清晰度得分，解码失败返回 -1
+   */
+  float scoreFrame(const camera_fb_t *fb) {
+    if (!validateJpegData(fb->buf, fb->len)) return -1.0f;
+
+    JpegGray::Image gray;
+    if (!JpegGray::decode(fb->buf, fb->len, CAM_BURST_SCORE_SCALE, gray)) return -1.0f;
+    float score = Sharpness::score(gray.pixels, gray.width, gray.height);
+    JpegGray::release(gray);
+    return score;
+  }
+
+  /**
+   * @brief 继续连拍，currentFrame 替换为得分最高的一帧
+   */
+  void keepSharpestFrame() {
+    float best = scoreFrame(currentFrame);
+    DEBUG_PRINTF("[相机] 连拍 1/%d 得分 %.0f\n", CAM_BURST_FRAMES, best);
+
+    for (int i = 1; i < CAM_BURST_FRAMES; i++) {
+      camera_fb_t *fb = esp_camera_fb_get();
+      if (!fb) continue;
+      float score = scoreFrame(fb);
+      DEBUG_PRINTF("[相机] 连拍 %d/%d 得分 %.0f\n", i + 1, CAM_BURST_FRAMES, score);
+      if (score > best) {
+        esp_camera_fb_return(currentFrame);
+        currentFrame = fb;
+        best = score;
+      } else {
+        esp_camera_fb_return(fb);
+      }
+    }
+  }
+#endif
+
 public:
   OV2640_Camera() : initialized(false), currentFrame(nullptr) {}
 
@@ -73,10 +257,16 @@ public:
     
     // 1. 电源控制
     pinMode(PIN_CAM_PWDN, OUTPUT);
+#if ENABLE_FAST_BOOT
+    // esp_camera_init() 会先探测 SCCB，此处只需短暂等待
+    digitalWrite(PIN_CAM_PWDN, LOW);
+    delay(CAM_PWDN_SETTLE_MS);
+#else
     digitalWrite(PIN_CAM_PWDN, HIGH);
     delay(10);
     digitalWrite(PIN_CAM_PWDN, LOW);
     delay(100);
+#endif
 
     // 2. 配置相机参数
     camera_config_t config = {};
@@ -106,8 +296,13 @@ public:
     config.xclk_freq_hz = CAM_XCLK_FREQ_HZ;
     config.pixel_format = PIXFORMAT_JPEG;
     config.frame_size = CAM_FRAME_SIZE;
-    config.jpeg_quality = CAM_JPEG_QUALITY;
+    jpegQuality = chooseQuality();
+    config.jpeg_quality = jpegQuality;
+#if ENABLE_CAM_BURST
+    config.fb_count = CAM_BURST_FB_COUNT;
+#else
     config.fb_count = CAM_FB_COUNT;
+#endif
     config.fb_location = CAMERA_FB_IN_PSRAM;
     config.grab_mode = CAMERA_GRAB_LATEST;
 
@@ -119,12 +314,10 @@ public:
       return false;
     }
 
-    // 4. 丢弃前几帧，等待自动曝光稳定
-    delay(200);
-    for (int i = 0; i < 5; i++) {
-      camera_fb_t *fb = esp_camera_fb_get();
-      if (fb) esp_camera_fb_return(fb);
-      delay(50);
+    // 4. 曝光记录有效时跳过预热，否则丢弃前几帧等待自动曝光稳定
+    bool restore = isAeCacheFresh();
+    if (!restore) {
+      discardWarmupFrames();
     }
 
     // 5. 调整传感器设置
@@ -139,6 +332,17 @@ public:
       s->set_aec2(s, 0);
       s->set_gain_ctrl(s, 1);
     }
+    if (restore && s) {
+      writeAe(s, g_camAeState.aec, g_camAeState.agc);
+      // CAMERA_GRAB_LATEST 下缓冲中可能是写寄存器前已开始曝光的帧，丢弃这一帧
+      camera_fb_t *fb = esp_camera_fb_get();
+      if (fb) esp_camera_fb_return(fb);
+      aeRestored = true;
+      DEBUG_PRINTF("[相机] 写回曝光 AEC=%u AGC=%u（%lu 秒前），跳过预热\n", g_camAeState.aec,
+                   g_camAeState.agc, (unsigned long)(rtcNowSeconds() - g_camAeState.savedAt));
+    } else if (restore) {
+      discardWarmupFrames();
+    }
 
     DEBUG_PRINTLN("[相机] ✓ 初始化成功");
     initialized = true;
@@ -171,6 +375,30 @@ public:
       return false;
     }
 
+    if (!saveAe()) {
+      DEBUG_PRINTLN("[相机] 场景明暗已变，预热后重拍");
+      releasePhoto();
+      discardWarmupFrames();
+      currentFrame = esp_camera_fb_get();
+      if (!currentFrame) {
+        DEBUG_PRINTLN("[相机] ❌ 拍照失败");
+        return false;
+      }
+      saveAe();
+    }
+
+#if ENABLE_CAM_BURST
+    keepSharpestFrame();
+#endif
+
+#if ENABLE_CAM_RATE_CONTROL
+    g_camRateState.magic = RATE_MAGIC;
+    g_camRateState.lastSize = currentFrame->len;
+    g_camRateState.quality = jpegQuality;
+    DEBUG_PRINTF("[相机] JPEG %u bytes / 预算 %u bytes，质量 %d\n", (unsigned)currentFrame->len,
+                 (unsigned)byteBudget, jpegQuality);
+#endif
+
     captureCount++;
     lastCaptureTime = millis();
 
@@ -200,6 +428,10 @@ public:
 
   bool isReady() const override { return initialized; }
 
+  void setByteBudget(size_t bytes) override { byteBudget = bytes; }
+
+  int getJpegQuality() const override { return jpegQuality; }
+
   // ========== 辅助方法 ==========
 
   uint32_t getCaptureCount() const { return captureCount; }
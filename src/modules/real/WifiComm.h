@@ -91,6 +91,29 @@ public:
     }
   }
 
+  // 贝壳云没有音频接口，录音发往自建平台
+  bool uploadAudio(const uint8_t *audioData, size_t audioSize,
+                   const char *metadata = nullptr) override {
+    if (WiFi.status() != WL_CONNECTED)
+      return false;
+
+    HTTPClient http;
+    String url = String(HTTP_USE_SSL ? "https://" : "http://") + HTTP_SERVER_HOST +
+                 ":" + HTTP_SERVER_PORT + HTTP_API_AUDIO;
+    http.begin(url);
+    http.addHeader("Content-Type", "audio/x-ima-adpcm");
+    if (metadata) {
+      http.addHeader("X-Metadata", metadata);
+    }
+
+    int httpCode = http.POST((uint8_t *)audioData, audioSize);
+    http.end();
+    if (httpCode <= 0) {
+      DEBUG_PRINTF("[通信] ❌ 录音上传失败: %s\n", http.errorToString(httpCode).c_str());
+    }
+    return (httpCode == 200);
+  }
+
   void sleep() override {
 #if !WIFI_KEEP_ALIVE
     if (connected) {
@@ -0,0 +1,200 @@
+#pragma once
+
+/**
+ * @file AudioClip.h
+ * @brief 噪音报警录音片段 - PSRAM 环形缓冲 + IMA-ADPCM (4:1) 编码
+ *
+ * 流程:
+ *   1. AudioSensor_ADC 每读取一个窗口就 push() 进环形缓冲（保留最近 AUDIO_CLIP_PRE_MS）
+ *   2. 噪音报警成立时传感器继续采集 AUDIO_CLIP_POST_MS，随后 freeze(实际采集的触发后样本数)
+ *   3. freeze() 按时间顺序取出环形缓冲，去直流后编码为 IMA-ADPCM
+ *   4. 报警流水线在噪音报警的照片之后通过 IComm::uploadAudio() 上传，元数据见 metadataJson()
+ *
+ * 编码格式:
+ *   - 单声道，每样本 4 位，每字节两个样本（低半字节在前）
+ *   - 解码初值 (predictor / index) 放在元数据中，无 WAV 头
+ *
+ * @note 环形缓冲和编码结果都在 PSRAM 中，进程内常驻，深度睡眠后失效。
+ *       深度睡眠模式下"触发前"只包含本次唤醒已采集的窗口
+ */
+
+#include "../../include/AppConfig.h"
+#include "esp_heap_caps.h"
+
+class AudioClip {
+private:
+  static const size_t RING_SAMPLES =
+      (size_t)(AUDIO_CLIP_PRE_MS + AUDIO_CLIP_POST_MS) * AUDIO_SAMPLE_RATE_HZ / 1000;
+
+  static uint16_t *ring;   // 12 位原始样本（PSRAM）
+  static size_t head;      // 下一个写入位置
+  static size_t filled;    // 有效样本数
+  static bool frozen;
+
+  static uint8_t *encoded; // ADPCM 数据（PSRAM）
+  static size_t encodedSize;
+  static size_t encodedSamples;
+  static size_t encodedPreSamples; // 其中触发前的样本数
+  static int16_t initPredictor;
+  static uint8_t initIndex;
+
+  static const int8_t INDEX_TABLE[16];
+  static const int16_t STEP_TABLE[89];
+
+  static bool ensureRing() {
+    if (ring) return true;
+    ring = (uint16_t *)heap_caps_malloc(RING_SAMPLES * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    if (!ring) {
+      DEBUG_PRINTLN("[录音] ❌ PSRAM 分配失败，报警不附带录音");
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 编码一个样本，返回 4 位码字
+   */
+  static uint8_t encodeSample(int16_t sample, int32_t &predictor, int &index) {
+    int step = STEP_TABLE[index];
+    int diff = sample - predictor;
+    uint8_t code = 0;
+    if (diff < 0) {
+      code = 8;
+      diff = -diff;
+    }
+
+    int delta = step >> 3;
+    if (diff >= step) { code |= 4; diff -= step; delta += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; delta += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; delta += step; }
+
+    predictor += (code & 8) ? -delta : delta;
+    predictor = constrain(predictor, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+    index = constrain(index + INDEX_TABLE[code], 0, 88);
+    return code;
+  }
+
+public:
+  /**
+   * @brief 追加样本（冻结后忽略）
+   */
+  static void push(const uint16_t *samples, size_t count) {
+#if ENABLE_AUDIO_CLIP
+    if (frozen || !ensureRing()) return;
+    for (size_t i = 0; i < count; i++) {
+      ring[head] = samples[i];
+      head = (head + 1) % RING_SAMPLES;
+    }
+    filled = (filled + count < RING_SAMPLES) ? filled + count : RING_SAMPLES;
+#endif
+  }
+
+  /**
+   * @brief 冻结缓冲并编码为 ADPCM
+   * @param postSamples 触发后追加的样本数（其余为触发前）
+   * @return true=已生成录音片段
+   */
+  static bool freeze(size_t postSamples) {
+#if ENABLE_AUDIO_CLIP
+    if (frozen || filled == 0) return encoded != nullptr;
+    frozen = true;
+
+    size_t bytes = (filled + 1) / 2;
+    encoded = (uint8_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (!encoded) {
+      DEBUG_PRINTLN("[录音] ❌ 编码缓冲分配失败");
+      return false;
+    }
+
+    size_t start = (head + RING_SAMPLES - filled) % RING_SAMPLES;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < filled; i++) sum += ring[(start + i) % RING_SAMPLES];
+    int32_t mean = sum / filled;
+
+    // 12 位 → 16 位
+    int32_t predictor = (ring[start] - mean) * 16;
+    int index = 0;
+    initPredictor = (int16_t)predictor;
+    initIndex = 0;
+    for (size_t i = 0; i < filled; i++) {
+      int16_t s = (int16_t)constrain((ring[(start + i) % RING_SAMPLES] - mean) * 16,
+                                     (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+      uint8_t code = encodeSample(s, predictor, index);
+      if (i & 1) {
+        encoded[i / 2] |= code << 4;
+      } else {
+        encoded[i / 2] = code;
+      }
+    }
+    encodedSize = bytes;
+    encodedSamples = filled;
+    encodedPreSamples = filled - min(postSamples, filled);
+
+    DEBUG_PRINTF("[录音] ✓ %u 样本 (%lu ms) → %u bytes ADPCM\n", (unsigned)filled,
+                 (unsigned long)(filled * 1000UL / AUDIO_SAMPLE_RATE_HZ), (unsigned)bytes);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static bool isReady() { return encoded != nullptr; }
+
+  static const uint8_t *data() { return encoded; }
+  static size_t size() { return encodedSize; }
+
+  /**
+   * @brief 上传元数据（解码所需参数）
+   */
+  static String metadataJson(const char *type) {
+    char buf[192];
+    snprintf(buf, sizeof(buf),
+             "{\"device_id\":\"%s\",\"type\":\"%s\",\"codec\":\"ima-adpcm\","
+             "\"rate\":%u,\"samples\":%u,\"pre_ms\":%u,\"predictor\":%d,\"index\":%u}",
+             HTTP_DEVICE_ID, type, (unsigned)AUDIO_SAMPLE_RATE_HZ,
+             (unsigned)encodedSamples,
+             (unsigned)(encodedPreSamples * 1000UL / AUDIO_SAMPLE_RATE_HZ), initPredictor,
+             initIndex);
+    return String(buf);
+  }
+
+  /**
+   * @brief 释放编码结果并解冻，环形缓冲保留供下次使用
+   */
+  static void release() {
+    if (encoded) heap_caps_free(encoded);
+    encoded = nullptr;
+    encodedSize = 0;
+    encodedSamples = 0;
+    encodedPreSamples = 0;
+    frozen = false;
+    head = 0;
+    filled = 0;
+  }
+};
+
+// 静态成员初始化
+uint16_t *AudioClip::ring = nullptr;
+size_t AudioClip::head = 0;
+size_t AudioClip::filled = 0;
+bool AudioClip::frozen = false;
+uint8_t *AudioClip::encoded = nullptr;
+size_t AudioClip::encodedSize = 0;
+size_t AudioClip::encodedSamples = 0;
+size_t AudioClip::encodedPreSamples = 0;
+int16_t AudioClip::initPredictor = 0;
+uint8_t AudioClip::initIndex = 0;
+
+const int8_t AudioClip::INDEX_TABLE[16] = {-1, -1, -1, -1, 2, 4, 6, 8,
+                                           -1, -1, -1, -1, 2, 4, 6, 8};
+
+const int16_t AudioClip::STEP_TABLE[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
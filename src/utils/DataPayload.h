@@ -69,6 +69,49 @@ struct TiltAlarmPayload {
     }
 };
 
+/**
+ * @brief 缓慢蠕变报警数据结构体（趋势见 TiltTrend.h）
+ */
+struct CreepAlarmPayload {
+    float angle;            // 本次巡检倾角
+    float slopePerDay;      // 回归斜率 (°/天)
+    float daysToThreshold;  // 预计到达报警阈值的天数
+    float voltage;          // 电池电压
+    GpsLocation location;   // GPS 坐标（无效时为 0,0）
+    unsigned long timestamp; // 时间戳
+    
+    CreepAlarmPayload(float ang, float slope, float days, float vol)
+        : angle(ang), slopePerDay(slope), daysToThreshold(days), voltage(vol),
+          location(), timestamp(millis()) {}
+    CreepAlarmPayload(float ang, float slope, float days, float vol, double lat, double lon)
+        : angle(ang), slopePerDay(slope), daysToThreshold(days), voltage(vol),
+          location(lat, lon), timestamp(millis()) {}
+    
+    bool hasValidGps() const { return location.latitude != 0.0 || location.longitude != 0.0; }
+    
+    String toJson() const {
+        StaticJsonDocument<320> doc;
+        doc["type"] = "CREEP";
+        doc["angle"] = serialized(String(angle, 2));
+        doc["slopePerDay"] = serialized(String(slopePerDay, 4));
+        doc["daysToThreshold"] = serialized(String(daysToThreshold, 0));
+        doc["voltage"] = serialized(String(voltage, 2));
+        doc["timestamp"] = timestamp;
+        
+        if (hasValidGps()) {
+            JsonObject locObj = doc.createNestedObject("location");
+            locObj["lat"] = serialized(String(location.latitude, 6));
+            locObj["lon"] = serialized(String(location.longitude, 6));
+        } else {
+            doc["location"] = nullptr;
+        }
+        
+        String json;
+        serializeJson(doc, json);
+        return json;
+    }
+};
+
 /**
  * @brief 低电量报警数据结构体
  */
@@ -113,17 +156,18 @@ struct NoiseAlarmPayload {
     float soundDb;          // 声音分贝 (dB)
     GpsLocation location;   // GPS 坐标
     unsigned long timestamp; // 时间戳
+    const char *label;      // 声音分类标签（nullptr=未分类）
     
     NoiseAlarmPayload() : voltage(0.0f), soundDb(30.0f), 
-                          location(), timestamp(0) {}
+                          location(), timestamp(0), label(nullptr) {}
     
     NoiseAlarmPayload(float vol, float db = 30.0f) 
         : voltage(vol), soundDb(db),
-          location(), timestamp(millis()) {}
+          location(), timestamp(millis()), label(nullptr) {}
     
     NoiseAlarmPayload(float vol, float db, double lat, double lon) 
         : voltage(vol), soundDb(db),
-          location(lat, lon), timestamp(millis()) {}
+          location(lat, lon), timestamp(millis()), label(nullptr) {}
     
     bool hasValidGps() const { return location.latitude != 0.0 || location.longitude != 0.0; }
     
@@ -132,6 +176,7 @@ struct NoiseAlarmPayload {
         doc["type"] = "NOISE";
         doc["voltage"] = serialized(String(voltage, 2));
         doc["soundDb"] = serialized(String(soundDb, 1));
+        if (label) doc["label"] = label;
         doc["timestamp"] = timestamp;
         
         if (hasValidGps()) {
@@ -158,6 +203,9 @@ struct StatusPayload {
     unsigned long uptime;  // 运行时间（秒）
     String version;        // 固件版本
     GpsLocation location;  // GPS 坐标
+    String profile;        // 唤醒周期耗时摘要（WakeProfiler::summaryJson，可为空）
+    String energy;         // 能耗账本摘要（EnergyLedger::summaryJson，可为空）
+    String samples;        // 批量样本（SampleBatch::toJson，可为空）
     
     StatusPayload() : angle(0.0f), voltage(0.0f), soundDb(30.0f),
                       uptime(0), version(FIRMWARE_VERSION), location() {}
@@ -172,14 +220,30 @@ struct StatusPayload {
     
     bool hasValidGps() const { return location.latitude != 0.0 || location.longitude != 0.0; }
     
+    /**
+     * @brief 序列化；文档容量按附加摘要的实际长度分配
+     * @return 空串=容量不足（调用者应去掉 samples 重试，并保留批量样本）
+     */
     String toJson() const {
-        StaticJsonDocument<512> doc;
+        // serialized(String) 会复制到文档内存池，需计入各摘要长度
+        DynamicJsonDocument doc(JSON_OBJECT_SIZE(10) + JSON_OBJECT_SIZE(2) + 192 +
+                                version.length() + profile.length() + energy.length() +
+                                samples.length());
         doc["type"] = "STATUS";
         doc["angle"] = serialized(String(angle, 2));
         doc["voltage"] = serialized(String(voltage, 2));
         doc["soundDb"] = serialized(String(soundDb, 1));
         doc["uptime"] = uptime;
         doc["version"] = version;
+        if (profile.length() > 0) {
+            doc["prof"] = serialized(profile);
+        }
+        if (energy.length() > 0) {
+            doc["energy"] = serialized(energy);
+        }
+        if (samples.length() > 0) {
+            doc["samples"] = serialized(samples);
+        }
         
         if (hasValidGps()) {
             JsonObject locObj = doc.createNestedObject("location");
@@ -188,6 +252,37 @@ struct StatusPayload {
         } else {
             doc["location"] = nullptr;
         }
+        if (doc.overflowed()) {
+            return String();
+        }
+        
+        String json;
+        serializeJson(doc, json);
+        return json;
+    }
+};
+
+/**
+ * @brief 报警补充定位结构体（GPS 晚于报警就绪时单独补发）
+ */
+struct LocationPayload {
+    String ref;            // 关联的报警类型 ("tilt" / "noise")
+    GpsLocation location;  // GPS 坐标
+    unsigned long timestamp; // 时间戳
+    
+    LocationPayload() : ref(), location(), timestamp(0) {}
+    LocationPayload(const char *alarmType, double lat, double lon)
+        : ref(alarmType), location(lat, lon), timestamp(millis()) {}
+    
+    String toJson() const {
+        StaticJsonDocument<256> doc;
+        doc["type"] = "LOCATION";
+        doc["ref"] = ref;
+        doc["timestamp"] = timestamp;
+        
+        JsonObject locObj = doc.createNestedObject("location");
+        locObj["lat"] = serialized(String(location.latitude, 6));
+        locObj["lon"] = serialized(String(location.longitude, 6));
         
         String json;
         serializeJson(doc, json);
@@ -0,0 +1,93 @@
+#pragma once
+
+/**
+ * @file DeltaReporter.h
+ * @brief 变化驱动上报 - 读数均在死区内时跳过心跳，整个周期不开射频
+ *
+ * 判定规则（任一满足即上报）:
+ *   - 自上次上报后，任一唤醒的读数超出死区
+ *     |倾角 - 上报值| > DELTA_ANGLE_DEADBAND
+ *     |分贝 - 上报值| > DELTA_DB_DEADBAND
+ *     |电压 - 上报值| > DELTA_VOLTAGE_DEADBAND
+ *   - 距上次上报已超过 DELTA_MAX_SILENCE_SEC（保活，服务器据此判断在线）
+ *   - 尚无上报快照（首次上电）
+ *
+ * 上次上报的快照保存在 RTC 内存（定义于 main.cpp）。
+ * 批量模式下每个样本都参与判定，一批中只要有一个样本变化就整批上报。
+ */
+
+#include "../../include/AppConfig.h"
+#include "RtcClock.h"
+
+/**
+ * @brief 上次上报快照（RTC 内存）
+ */
+struct DeltaReportState {
+  uint32_t magic;
+  bool hasSnapshot;     // 是否已上报过
+  bool changed;         // 上报后是否出现超出死区的读数
+  float angle;          // 上报时的倾角 (°)
+  float soundDb;        // 上报时的分贝 (dB)
+  float voltage;        // 上报时的电压 (V)
+  uint32_t reportedAt;  // 上报时的 RTC 秒
+};
+
+class DeltaReporter {
+private:
+  static const uint32_t DELTA_MAGIC = 0x444C5441; // "DLTA"
+
+  static DeltaReportState state; // RTC 内存（定义于 main.cpp）
+
+public:
+  /**
+   * @brief 记录本次唤醒的读数，超出死区则标记需要上报
+   */
+  static void observe(float angle, float soundDb, float voltage) {
+    ensureState();
+    if (!state.hasSnapshot || state.changed) return;
+
+    if (fabsf(angle - state.angle) > DELTA_ANGLE_DEADBAND ||
+        fabsf(soundDb - state.soundDb) > DELTA_DB_DEADBAND ||
+        fabsf(voltage - state.voltage) > DELTA_VOLTAGE_DEADBAND) {
+      state.changed = true;
+      DEBUG_PRINTF("[变化] 读数超出死区 (%.2f° / %.0f dB / %.2fV)\n",
+                   angle, soundDb, voltage);
+    }
+  }
+
+  /**
+   * @brief 是否需要上报（有变化 / 静默超时 / 无快照）
+   */
+  static bool isReportDue() {
+    ensureState();
+    if (!state.hasSnapshot || state.changed) return true;
+
+    uint32_t silentSec = rtcNowSeconds() - state.reportedAt;
+    if (silentSec >= DELTA_MAX_SILENCE_SEC) {
+      DEBUG_PRINTF("[变化] 已静默 %lu 秒，保活上报\n", (unsigned long)silentSec);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 心跳已送达（或确已写入断网队列）后更新快照
+   */
+  static void markReported(float angle, float soundDb, float voltage) {
+    ensureState();
+    state.hasSnapshot = true;
+    state.changed = false;
+    state.angle = angle;
+    state.soundDb = soundDb;
+    state.voltage = voltage;
+    state.reportedAt = rtcNowSeconds();
+  }
+
+private:
+  static void ensureState() {
+    if (state.magic != DELTA_MAGIC) {
+      memset(&state, 0, sizeof(state));
+      state.magic = DELTA_MAGIC;
+    }
+  }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+/**
+ * @file EnergyLedger.h
+ * @brief 能耗账本 - 按阶段耗时 × 电流模型估算 mAh，并预测剩余续航
+ *
+ * 估算方法:
+ *   周期能耗 = 周期总时长 × CPU 电流
+ *            + GPS 阶段 × GPS 电流
+ *            + (WiFi + HTTP 阶段) × WiFi 电流
+ *            + 相机阶段 × 相机电流
+ *            + 睡眠时长 × 睡眠电流
+ *            + 全程 × 分压电阻漏电
+ *   电流模型见 Settings.h「电池管理」一节，仅用于估算，不参与控制
+ *
+ * 睡眠时长取实际值：入睡时记下 RTC 时刻，下次启动 (recordWake) 按时间差记账，
+ * 因此声音/倾斜/ULP 提前唤醒不会按排定的整段睡眠多计
+ *
+ * 按天累计（以累计的唤醒+睡眠时长划分"天"，无需实时时钟），
+ * 最近 ENERGY_HISTORY_DAYS 天的日耗电量保存在 RTC 内存中
+ */
+
+#include "../../include/AppConfig.h"
+#include "RtcClock.h"
+#include "WakeProfiler.h"
+
+/**
+ * @brief 账本状态（RTC 内存，定义于 main.cpp）
+ */
+struct EnergyLedgerState {
+  uint32_t magic;
+  float todayMah;                       // 当天累计
+  uint32_t todaySec;                    // 当天已累计时长 (s)
+  float lastCycleMah;                   // 最近一个周期（含其后的睡眠）
+  uint32_t sleepStartAt;                // 入睡时刻 (RTC 秒)，0=无待记账的睡眠
+  float dailyMah[ENERGY_HISTORY_DAYS];  // 历史日耗电量
+  uint8_t head;
+  uint8_t count;
+};
+
+class EnergyLedger {
+private:
+  static const uint32_t LEDGER_MAGIC = 0x454E5232; // "ENR2"（状态布局变化时递增）
+  static const uint32_t SECONDS_PER_DAY = 86400;
+
+  static EnergyLedgerState state; // RTC 内存（定义于 main.cpp）
+
+public:
+  /**
+   * @brief 记账：一个已提交的唤醒周期，并记下入睡时刻（睡眠在 recordWake 中记账）
+   * @param rec 唤醒周期记录（WakeProfiler::getCycle(0)）
+   */
+  static void recordCycle(const WakeCycleRecord *rec) {
+    ensureState();
+    if (rec == nullptr) return;
+
+    // us × mA → mAh: 除以 3.6e9
+    double activeUsMa = (double)rec->totalUs * CURRENT_CPU_ACTIVE_MA +
+                        (double)rec->phaseUs[PHASE_GPS] * CURRENT_GPS_ACQ_MA +
+                        (double)(rec->phaseUs[PHASE_WIFI] + rec->phaseUs[PHASE_HTTP]) *
+                            CURRENT_WIFI_TX_MA +
+                        (double)rec->phaseUs[PHASE_CAMERA] * CURRENT_CAMERA_MA;
+    float activeMah = (float)(activeUsMa / 3.6e9);
+
+    uint32_t activeSec = rec->totalUs / 1000000;
+    float leakMah = activeSec * CURRENT_STATIC_LEAK_MA / 3600.0f;
+
+    state.lastCycleMah = activeMah + leakMah;
+    addToDay(state.lastCycleMah, activeSec);
+    state.sleepStartAt = rtcNowSeconds();
+
+    DEBUG_PRINTF("[能耗] 本周期活动 %.3f mAh (漏电 %.3f)\n", activeMah, leakMah);
+  }
+
+  /**
+   * @brief 唤醒后记账：上次入睡至今的实际睡眠时长（setup() 调用）
+   */
+  static void recordWake() {
+    ensureState();
+    uint32_t now = rtcNowSeconds();
+    uint32_t start = state.sleepStartAt;
+    state.sleepStartAt = 0;
+    if (start == 0 || now < start || now - start > SECONDS_PER_DAY * 7) return; // 时钟异常
+
+    uint32_t sleepSec = now - start;
+    float sleepMah = sleepSec * (CURRENT_DEEP_SLEEP_UA / 1000.0f) / 3600.0f +
+                     sleepSec * CURRENT_STATIC_LEAK_MA / 3600.0f;
+    state.lastCycleMah += sleepMah;
+    addToDay(sleepMah, sleepSec);
+
+    DEBUG_PRINTF("[能耗] 实际睡眠 %lu s, %.3f mAh，上周期合计 %.3f mAh\n",
+                 (unsigned long)sleepSec, sleepMah, state.lastCycleMah);
+  }
+
+  /**
+   * @brief 记账：唤醒桩直接回睡的次数（睡眠时长已计入上一周期，只补活动耗电）
+   */
+  static void recordStubWakes(uint16_t count) {
+    ensureState();
+    if (count == 0) return;
+    addToDay(count * (WAKE_STUB_ACTIVE_US * CURRENT_CPU_ACTIVE_MA / 3.6e9f), 0);
+  }
+
+  /**
+   * @brief 日均耗电量 (mAh/天)
+   * @note 有历史则取历史均值，否则按当天已累计部分外推
+   */
+  static float getDailyMah() {
+    ensureState();
+    if (state.count > 0) {
+      float sum = 0.0f;
+      for (uint8_t i = 0; i < state.count; i++) sum += state.dailyMah[i];
+      return sum / state.count;
+    }
+    if (state.todaySec == 0) return 0.0f;
+    return state.todayMah * SECONDS_PER_DAY / state.todaySec;
+  }
+
+  /**
+   * @brief 按当前电量与日均耗电量预测剩余续航（天，无太阳能补充）
+   * @return 负数=数据不足
+   */
+  static float projectRemainingDays(int batteryPercent) {
+    float daily = getDailyMah();
+    if (daily <= 0.0f) return -1.0f;
+    float remainingMah = BAT_CAPACITY_MAH * constrain(batteryPercent, 0, 100) / 100.0f;
+    return remainingMah / daily;
+  }
+
+  /**
+   * @brief 生成心跳用的紧凑摘要
+   *
+   * 格式: {"cyc":0.123,"today":12.3,"avg":40.1,"days":12.5}
+   */
+  static String summaryJson(int batteryPercent) {
+    ensureState();
+    char buf[96];
+    snprintf(buf, sizeof(buf),
+             "{\"cyc\":%.3f,\"today\":%.1f,\"avg\":%.1f,\"days\":%.1f}",
+             state.lastCycleMah, state.todayMah, getDailyMah(),
+             projectRemainingDays(batteryPercent));
+    return String(buf);
+  }
+
+private:
+  static void addToDay(float mah, uint32_t sec) {
+    state.todayMah += mah;
+    state.todaySec += sec;
+
+    // 跨天：归档当天并清零
+    if (state.todaySec >= SECONDS_PER_DAY) {
+      state.dailyMah[state.head] = state.todayMah * SECONDS_PER_DAY / state.todaySec;
+      state.head = (state.head + 1) % ENERGY_HISTORY_DAYS;
+      if (state.count < ENERGY_HISTORY_DAYS) state.count++;
+      DEBUG_PRINTF("[能耗] 📅 日结: %.1f mAh\n", state.todayMah);
+      state.todayMah = 0.0f;
+      state.todaySec = 0;
+    }
+  }
+
+  static void ensureState() {
+    if (state.magic != LEDGER_MAGIC || state.head >= ENERGY_HISTORY_DAYS ||
+        state.count > ENERGY_HISTORY_DAYS) {
+      memset(&state, 0, sizeof(state));
+      state.magic = LEDGER_MAGIC;
+    }
+  }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+/**
+ * @file FlashFs.h
+ * @brief LittleFS 共享挂载 - 断网队列、图片缓存、画面参考图共用一个分区
+ *
+ * 报警流水线中相机任务与调用者任务可能同时首次访问文件系统，
+ * LittleFS.begin() 本身不可重入，因此挂载集中在这里并由互斥锁保护。
+ * 挂载仍是按需的：不碰文件系统的唤醒周期不付出挂载耗时。
+ *
+ * @note init() 须在 setup() 中、任何任务创建之前调用
+ */
+
+#include "../../include/AppConfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <LittleFS.h>
+
+class FlashFs {
+private:
+  static SemaphoreHandle_t mutex;
+  static volatile bool mounted;
+
+public:
+  /**
+   * @brief 创建互斥锁（setup() 调用）
+   */
+  static void init() {
+    if (!mutex) mutex = xSemaphoreCreateMutex();
+  }
+
+  /**
+   * @brief 按需挂载（首次失败时格式化）
+   * @return true=已挂载
+   */
+  static bool mount() {
+    if (mounted) return true;
+    if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+    if (!mounted) {
+      mounted = LittleFS.begin(true);
+      if (!mounted) {
+        DEBUG_PRINTLN("[文件] ❌ LittleFS 挂载失败");
+      }
+    }
+    if (mutex) xSemaphoreGive(mutex);
+    return mounted;
+  }
+};
+
+// 静态成员初始化
+SemaphoreHandle_t FlashFs::mutex = nullptr;
+volatile bool FlashFs::mounted = false;
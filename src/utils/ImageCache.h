@@ -0,0 +1,204 @@
+#pragma once
+
+/**
+ * @file ImageCache.h
+ * @brief 两级图片上传 - 报警只带灰度缩略图，原图缓存在 LittleFS，按需上传
+ *
+ * 流程:
+ *   1. 相机任务拍照后 save() 把原图写入 IMG_CACHE_DIR/<id>.jpg，id 为 RTC 秒
+ *   2. makeThumbnail() 生成 IMG_THUMB_WIDTH×IMG_THUMB_HEIGHT 灰度 JPEG，随报警上传
+ *      元数据: {"device_id":..,"type":..,"tier":"thumb","image_id":<id>,
+ *               "full_bytes":<原图大小>,"quality":<原图 JPEG 质量>}
+ *      image_id 为 0 表示"无原图"（画面未变化，见 SceneChange；或缓存失败）
+ *   3. 服务器在下行响应中请求原图（报警响应或之后任一次心跳响应均可）:
+ *      {"command":"upload_image","image_id":<id>}   指定一张（id 非 0）
+ *      {"command":"upload_image","latest":true}     最近一张
+ *      image_id 为 0 或两者均无的请求被忽略
+ *      handleDownlink() 读出原图上传 (tier="full")，成功后删除缓存文件
+ *
+ * 缓存最多保留 IMG_CACHE_MAX_FILES 张，写入前按 id 从旧到新淘汰，
+ * 分区空间不足时同样淘汰最旧的。
+ *
+ * @note 与 TelemetryQueue 共用 LittleFS 分区
+ */
+
+#include "../../include/AppConfig.h"
+#include "../interfaces/IComm.h"
+#include "FlashFs.h"
+#include "JpegGray.h"
+#include "RtcClock.h"
+#include "img_converters.h"
+#include <LittleFS.h>
+
+class ImageCache {
+private:
+  static bool begin() {
+    if (!FlashFs::mount()) return false;
+    if (!LittleFS.exists(IMG_CACHE_DIR)) LittleFS.mkdir(IMG_CACHE_DIR);
+    return true;
+  }
+
+  static String pathOf(uint32_t id) { return String(IMG_CACHE_DIR "/") + id + ".jpg"; }
+
+  /**
+   * @brief 遍历缓存，返回文件数，并给出最旧/最新的 id
+   */
+  static int scan(uint32_t &oldest, uint32_t &newest) {
+    oldest = UINT32_MAX;
+    newest = 0;
+    int count = 0;
+    File dir = LittleFS.open(IMG_CACHE_DIR);
+    if (!dir) return 0;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+      uint32_t id = strtoul(f.name(), nullptr, 10);
+      f.close();
+      if (id == 0) continue;
+      oldest = min(oldest, id);
+      newest = max(newest, id);
+      count++;
+    }
+    dir.close();
+    return count;
+  }
+
+  static void evictFor(size_t len) {
+    uint32_t oldest, newest;
+    int count = scan(oldest, newest);
+    while (count > 0 && (count >= IMG_CACHE_MAX_FILES ||
+                         LittleFS.totalBytes() - LittleFS.usedBytes() < len + IMG_CACHE_RESERVE_BYTES)) {
+      LittleFS.remove(pathOf(oldest));
+      DEBUG_PRINTF("[图片] 淘汰缓存 #%lu\n", (unsigned long)oldest);
+      count = scan(oldest, newest);
+    }
+  }
+
+  static String metadata(const char *type, const char *tier, uint32_t id) {
+    String json = String("{\"device_id\":\"") + HTTP_DEVICE_ID + "\"";
+    if (type) json += String(",\"type\":\"") + type + "\"";
+    return json + ",\"tier\":\"" + tier + "\",\"image_id\":" + id + "}";
+  }
+
+public:
+  /**
+   * @brief 缓存原图
+   * @return 图片 id，失败返回 0
+   */
+  static uint32_t save(const uint8_t *jpeg, size_t len) {
+    if (!begin()) return 0;
+    evictFor(len);
+
+    uint32_t id = rtcNowSeconds();
+    uint32_t oldest, newest;
+    if (scan(oldest, newest) > 0 && id <= newest) id = newest + 1; // id 单调递增
+
+    File f = LittleFS.open(pathOf(id), FILE_WRITE);
+    if (!f) {
+      DEBUG_PRINTLN("[图片] ❌ 缓存文件打开失败");
+      return 0;
+    }
+    size_t written = f.write(jpeg, len);
+    f.close();
+    if (written != len) {
+      LittleFS.remove(pathOf(id));
+      DEBUG_PRINTLN("[图片] ❌ 缓存写入不完整");
+      return 0;
+    }
+    DEBUG_PRINTF("[图片] 原图已缓存 #%lu (%u bytes)\n", (unsigned long)id, (unsigned)len);
+    return id;
+  }
+
+  /**
+   * @brief 生成灰度缩略图 JPEG
+   * @param out 输出缓冲（由 fmt2jpg 分配，调用者 free()）
+   */
+  static bool makeThumbnail(const uint8_t *jpeg, size_t len, uint8_t **out, size_t *outLen) {
+    JpegGray::Image decoded, thumb;
+    bool ok = JpegGray::decode(jpeg, len, IMG_THUMB_DECODE_SCALE, decoded) &&
+              JpegGray::resize(decoded, IMG_THUMB_WIDTH, IMG_THUMB_HEIGHT, thumb) &&
+              fmt2jpg(thumb.pixels, (size_t)thumb.width * thumb.height, thumb.width,
+                      thumb.height, PIXFORMAT_GRAYSCALE, IMG_THUMB_QUALITY, out, outLen);
+    JpegGray::release(decoded);
+    JpegGray::release(thumb);
+    if (!ok) {
+      DEBUG_PRINTLN("[图片] ⚠️ 缩略图生成失败");
+    }
+    return ok;
+  }
+
+  /**
+   * @brief 上传缩略图
+   * @param fullBytes,quality 原图大小与 JPEG 质量，供服务器判断是否需要原图
+   */
+  static bool uploadThumbnail(IComm *commModule, const char *type, uint32_t id,
+                              const uint8_t *thumb, size_t len, size_t fullBytes, int quality) {
+    String json = metadata(type, "thumb", id);
+    json.remove(json.length() - 1);
+    json += String(",\"full_bytes\":") + fullBytes + ",\"quality\":" + quality + "}";
+    return commModule->uploadImage(thumb, len, json.c_str());
+  }
+
+  /**
+   * @brief 上传缓存的原图，成功后删除
+   * @param id 图片 id；latest=true 时忽略，取最近一张
+   */
+  static bool uploadFull(IComm *commModule, uint32_t id, bool latest = false) {
+    if (!begin()) return false;
+    if (latest) {
+      uint32_t oldest;
+      if (scan(oldest, id) == 0) {
+        DEBUG_PRINTLN("[图片] ⚠️ 缓存为空");
+        return false;
+      }
+    }
+    if (id == 0) return false; // 0 保留为"无原图"
+
+    File f = LittleFS.open(pathOf(id), FILE_READ);
+    if (!f) {
+      DEBUG_PRINTF("[图片] ⚠️ 原图 #%lu 不在缓存中\n", (unsigned long)id);
+      return false;
+    }
+    size_t len = f.size();
+    uint8_t *buf = (uint8_t *)heap_caps_malloc(len, MALLOC_CAP_SPIRAM);
+    bool ok = buf && f.read(buf, len) == len;
+    f.close();
+
+    if (ok) {
+      DEBUG_PRINTF("[上报] 📷 原图 #%lu: %u bytes\n", (unsigned long)id, (unsigned)len);
+      ok = commModule->uploadImage(buf, len, metadata(nullptr, "full", id).c_str());
+    }
+    if (buf) heap_caps_free(buf);
+
+    if (ok) {
+      LittleFS.remove(pathOf(id));
+      DEBUG_PRINTLN("[上报] ✓ 原图上传成功");
+    } else {
+      DEBUG_PRINTLN("[上报] ⚠️ 原图上传失败，保留缓存");
+    }
+    return ok;
+  }
+
+  /**
+   * @brief 处理下行响应中的原图请求
+   * @return true=响应包含请求并已处理
+   */
+  static bool handleDownlink(IComm *commModule, const char *response) {
+#if ENABLE_IMAGE_TIERS
+    if (!response || !strstr(response, "\"command\"") || !strstr(response, "upload_image")) {
+      return false;
+    }
+    uint32_t id = 0;
+    const char *p = strstr(response, "\"image_id\":");
+    if (p) id = strtoul(p + strlen("\"image_id\":"), nullptr, 10);
+    bool latest = strstr(response, "\"latest\":true") != nullptr;
+    if (id == 0 && !latest) {
+      DEBUG_PRINTLN("[图片] 原图请求未指定图片，忽略");
+      return false;
+    }
+    DEBUG_PRINTF("[图片] 服务器请求原图 %s#%lu\n", latest ? "(最近) " : "", (unsigned long)id);
+    uploadFull(commModule, id, latest);
+    return true;
+#else
+    return false;
+#endif
+  }
+};
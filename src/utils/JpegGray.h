@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * @file JpegGray.h
+ * @brief JPEG 降采样解码为灰度图（PSRAM），及灰度图区域平均缩放
+ *
+ * 基于 esp32-camera 的 esp_jpg_decode()，解码时按 scale 降采样
+ * (0=原尺寸, 1=1/2, 2=1/4, 3=1/8)，比解码后再缩小快得多。
+ * 供相机连拍评分和缩略图生成共用。
+ *
+ * @note esp_jpg_decode() 的工作区为静态变量，不可在多个任务中同时调用
+ */
+
+#include "../../include/AppConfig.h"
+#include "esp_heap_caps.h"
+#include "esp_jpg_decode.h"
+
+class JpegGray {
+public:
+  /**
+   * @brief 灰度图，像素在 PSRAM 中，用 release() 释放
+   */
+  struct Image {
+    uint8_t *pixels = nullptr;
+    int width = 0;
+    int height = 0;
+  };
+
+  /**
+   * @brief 降采样解码
+   * @param scale 降采样级数 (jpg_scale_t)
+   */
+  static bool decode(const uint8_t *jpeg, size_t len, uint8_t scale, Image &out) {
+    Decoder d = {jpeg, &out};
+    release(out);
+    if (esp_jpg_decode(len, (jpg_scale_t)scale, read, write, &d) != ESP_OK || !out.pixels) {
+      release(out);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 区域平均缩放（只用于缩小）
+   */
+  static bool resize(const Image &src, int width, int height, Image &dst) {
+    release(dst);
+    if (!src.pixels || width > src.width || height > src.height) return false;
+    dst.pixels = (uint8_t *)heap_caps_malloc((size_t)width * height, MALLOC_CAP_SPIRAM);
+    if (!dst.pixels) return false;
+    dst.width = width;
+    dst.height = height;
+
+    for (int y = 0; y < height; y++) {
+      int y0 = y * src.height / height;
+      int y1 = (y + 1) * src.height / height;
+      for (int x = 0; x < width; x++) {
+        int x0 = x * src.width / width;
+        int x1 = (x + 1) * src.width / width;
+        uint32_t sum = 0;
+        for (int sy = y0; sy < y1; sy++) {
+          const uint8_t *row = src.pixels + (size_t)sy * src.width;
+          for (int sx = x0; sx < x1; sx++) sum += row[sx];
+        }
+        dst.pixels[(size_t)y * width + x] = sum / ((y1 - y0) * (x1 - x0));
+      }
+    }
+    return true;
+  }
+
+  static void release(Image &img) {
+    if (img.pixels) heap_caps_free(img.pixels);
+    img = Image();
+  }
+
+private:
+  struct Decoder {
+    const uint8_t *jpeg;
+    Image *out;
+  };
+
+  static size_t read(void *arg, size_t index, uint8_t *buf, size_t len) {
+    Decoder *d = (Decoder *)arg;
+    if (buf) memcpy(buf, d->jpeg + index, len);
+    return len;
+  }
+
+  static bool write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data) {
+    Image *out = ((Decoder *)arg)->out;
+    if (!data) {
+      // 开始通知携带输出尺寸；结束通知时已分配，忽略
+      if (x == 0 && y == 0 && !out->pixels) {
+        out->pixels = (uint8_t *)heap_caps_malloc((size_t)w * h, MALLOC_CAP_SPIRAM);
+        out->width = w;
+        out->height = h;
+      }
+      return out->pixels != nullptr;
+    }
+
+    for (uint16_t j = 0; j < h && y + j < out->height; j++) {
+      uint8_t *dst = out->pixels + (size_t)(y + j) * out->width + x;
+      const uint8_t *px = data + (size_t)j * w * 3;
+      for (uint16_t i = 0; i < w && x + i < out->width; i++, px += 3) {
+        dst[i] = (px[0] + 2 * px[1] + px[2]) >> 2; // 近似亮度，与 R/B 顺序无关
+      }
+    }
+    return true;
+  }
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file NoiseFloor.h
+ * @brief 自适应噪音基线 - 按小时分桶的指数滑动均值/方差（RTC 内存）
+ *
+ * 每次唤醒测得的 Leq 更新当前小时桶和全局桶:
+ *   a    = max(1/(n+1), 1/NOISE_FLOOR_TAU)      // 前几个样本快速收敛
+ *   mean += a·(x - mean)
+ *   var   = (1-a)·(var + a·(x - mean)²)
+ *
+ * 报警阈值 = 基线均值 + max(NOISE_FLOOR_K_SIGMA·σ, NOISE_FLOOR_MIN_MARGIN_DB)
+ *   - 当前小时桶样本 ≥ NOISE_FLOOR_WARMUP 时用该桶，否则用全局桶
+ *   - 全局桶也未热身时退回固定阈值 NOISE_THRESHOLD_DB
+ *   - 更新前把读数截断到阈值，报警事件本身不会把基线抬高
+ *
+ * @note 设备没有校时，"小时"取 RTC 时钟秒数 / 3600 对 24 取模。
+ *       分桶与本地时间有固定相位差，但仍能区分一天中的不同时段；断电后基线重新学习
+ */
+
+#include "../../include/AppConfig.h"
+#include "RtcClock.h"
+#include <math.h>
+
+/**
+ * @brief RTC 状态（定义于 main.cpp），最后一项为全局桶
+ */
+struct NoiseFloorState {
+  uint32_t magic;
+  float mean[NOISE_FLOOR_BINS + 1]; // dB(A)
+  float var[NOISE_FLOOR_BINS + 1];  // dB²
+  uint16_t count[NOISE_FLOOR_BINS + 1];
+};
+
+class NoiseFloor {
+private:
+  static const uint32_t FLOOR_MAGIC = 0x4E464C52; // "NFLR"
+  static const uint8_t GLOBAL_BIN = NOISE_FLOOR_BINS;
+
+  static NoiseFloorState state; // RTC 内存（定义于 main.cpp）
+
+  static uint8_t currentBin() {
+    return (rtcNowSeconds() / 3600) % NOISE_FLOOR_BINS;
+  }
+
+  static bool isWarm(uint8_t bin) { return state.count[bin] >= NOISE_FLOOR_WARMUP; }
+
+  static float thresholdFor(uint8_t bin) {
+    float margin = max(NOISE_FLOOR_K_SIGMA * sqrtf(state.var[bin]), NOISE_FLOOR_MIN_MARGIN_DB);
+    return state.mean[bin] + margin;
+  }
+
+  static void updateBin(uint8_t bin, float x) {
+    if (isWarm(bin)) x = min(x, thresholdFor(bin));
+
+    uint16_t &n = state.count[bin];
+    if (n == 0) {
+      state.mean[bin] = x;
+      state.var[bin] = 0.0f;
+    } else {
+      float a = max(1.0f / (n + 1), 1.0f / NOISE_FLOOR_TAU);
+      float diff = x - state.mean[bin];
+      state.mean[bin] += a * diff;
+      state.var[bin] = (1.0f - a) * (state.var[bin] + a * diff * diff);
+    }
+    if (n < UINT16_MAX) n++;
+  }
+
+  static void ensureState() {
+    if (state.magic != FLOOR_MAGIC) {
+      memset(&state, 0, sizeof(state));
+      state.magic = FLOOR_MAGIC;
+    }
+  }
+
+public:
+  /**
+   * @brief 当前时段的报警阈值 dB(A)
+   */
+  static float thresholdDb() {
+#if ENABLE_ADAPTIVE_NOISE_FLOOR
+    ensureState();
+    uint8_t bin = currentBin();
+    if (isWarm(bin)) return thresholdFor(bin);
+    if (isWarm(GLOBAL_BIN)) return thresholdFor(GLOBAL_BIN);
+#endif
+    return NOISE_THRESHOLD_DB;
+  }
+
+  /**
+   * @brief 当前时段的基线均值 dB(A)，尚未积累足够样本时返回 NAN
+   */
+  static float floorDb() {
+#if ENABLE_ADAPTIVE_NOISE_FLOOR
+    ensureState();
+    uint8_t bin = currentBin();
+    if (isWarm(bin)) return state.mean[bin];
+    if (isWarm(GLOBAL_BIN)) return state.mean[GLOBAL_BIN];
+#endif
+    return NAN;
+  }
+
+  /**
+   * @brief 用本次唤醒的 Leq 更新基线
+   */
+  static void update(float leqDb) {
+#if ENABLE_ADAPTIVE_NOISE_FLOOR
+    ensureState();
+    uint8_t bin = currentBin();
+    updateBin(bin, leqDb);
+    updateBin(GLOBAL_BIN, leqDb);
+    DEBUG_PRINTF("[基线] 时段 %u: %.1f±%.1f dB (n=%u), 全局 %.1f±%.1f dB\n", bin,
+                 state.mean[bin], sqrtf(state.var[bin]), state.count[bin],
+                 state.mean[GLOBAL_BIN], sqrtf(state.var[GLOBAL_BIN]));
+#endif
+  }
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+/**
+ * @file PowerManager.h
+ * @brief 分阶段电源策略 - 动态调频 (DFS) + 自动 Light-sleep
+ *
+ * 策略按唤醒阶段 (WakePhase) 配置，由 ProfileSpan 在进入/离开阶段时自动申请/释放:
+ *
+ *   策略         CPU 频率            Light-sleep   适用阶段
+ *   PM_IDLE     PM_MIN_FREQ_MHZ     允许          电池采样、WiFi 关联、睡眠收尾
+ *   PM_AWAKE    PM_MIN_FREQ_MHZ     禁止          倾角/声音采样、GPS 串口
+ *   PM_FULL     PM_MAX_FREQ_MHZ     禁止          HTTP/TLS、相机/JPEG
+ *
+ * 设计说明:
+ *   - 使用 ESP-IDF 电源管理锁（引用计数），报警流水线中并行阶段可同时持有
+ *   - delay() 即 vTaskDelay，空闲时由 IDLE 任务自动进入 Light-sleep，无需改写调用处；
+ *     实际只发生在 PM_IDLE 阶段（电池采样间隔、WiFi 关联轮询）
+ *   - WiFi 驱动在射频工作期间自行持有电源管理锁，关联轮询的 delay() 间隙可安全 Light-sleep
+ *   - GPS 阶段保持 PM_AWAKE：Light-sleep 期间 UART 停止接收，NMEA 语句会丢字节
+ *   - esp_pm_configure 拒绝 Light-sleep 时（如未开启 CONFIG_FREERTOS_USE_TICKLESS_IDLE）
+ *     改为仅 DFS；若 Arduino 核心未开启 CONFIG_PM_ENABLE，退化为按引用计数手动
+ *     setCpuFrequencyMhz()，此时无自动 Light-sleep
+ *   - 串口在 Light-sleep 期间暂停，调试日志可能被截断，可关闭 PM_AUTO_LIGHT_SLEEP
+ */
+
+#include "../../include/AppConfig.h"
+#include "esp_idf_version.h"
+#include "esp_pm.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+enum PowerPolicy : uint8_t {
+  PM_IDLE = 0, // 最低频率，允许 Light-sleep
+  PM_AWAKE,    // 最低频率，保持唤醒（外设/串口/DMA 工作中）
+  PM_FULL      // 最高频率
+};
+
+class PowerManager {
+private:
+  static bool pmActive;                  // esp_pm 已生效
+  static esp_pm_lock_handle_t cpuMaxLock;
+  static esp_pm_lock_handle_t noSleepLock;
+  static SemaphoreHandle_t manualMutex;  // 退化模式下保护计数与调频
+  static uint8_t manualFullCount;
+
+public:
+  /**
+   * @brief 阶段 → 策略（顺序同 WakePhase）
+   */
+  static PowerPolicy policyFor(uint8_t phase) {
+    static const PowerPolicy POLICY[] = {
+        PM_AWAKE, // PHASE_BOOT
+        PM_IDLE,  // PHASE_BATTERY
+        PM_AWAKE, // PHASE_TILT
+        PM_AWAKE, // PHASE_AUDIO
+        PM_AWAKE, // PHASE_GPS（UART 接收）
+        PM_IDLE,  // PHASE_WIFI（驱动自持锁）
+        PM_FULL,  // PHASE_HTTP
+        PM_FULL,  // PHASE_CAMERA
+        PM_IDLE,  // PHASE_SLEEP_ENTRY
+    };
+    return phase < sizeof(POLICY) / sizeof(POLICY[0]) ? POLICY[phase] : PM_AWAKE;
+  }
+
+  /**
+   * @brief 启用动态调频与自动 Light-sleep（setup() 最先调用）
+   */
+  static void init() {
+#if ENABLE_POWER_MANAGEMENT
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t config = {};
+#else
+    esp_pm_config_esp32s3_t config = {};
+#endif
+    config.max_freq_mhz = PM_MAX_FREQ_MHZ;
+    config.min_freq_mhz = PM_MIN_FREQ_MHZ;
+    config.light_sleep_enable = PM_AUTO_LIGHT_SLEEP;
+
+    esp_err_t err = esp_pm_configure(&config);
+    if (err != ESP_OK && config.light_sleep_enable) {
+      // 通常是未开启 tickless idle：保留 DFS，放弃自动 Light-sleep
+      DEBUG_PRINTF("[电源] ⚠️ Light-sleep 不可用 (0x%x)，仅启用 DFS\n", err);
+      config.light_sleep_enable = false;
+      err = esp_pm_configure(&config);
+    }
+    if (err == ESP_OK &&
+        esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "phase_full", &cpuMaxLock) == ESP_OK &&
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "phase_awake", &noSleepLock) == ESP_OK) {
+      pmActive = true;
+      DEBUG_PRINTF("[电源] ✓ DFS %d-%d MHz, Light-sleep %s\n", PM_MIN_FREQ_MHZ,
+                   PM_MAX_FREQ_MHZ, config.light_sleep_enable ? "开" : "关");
+      return;
+    }
+
+    // 退化：手动调频
+    DEBUG_PRINTF("[电源] ⚠️ esp_pm 不可用 (0x%x)，改为手动调频\n", err);
+    manualMutex = xSemaphoreCreateMutex();
+    setCpuFrequencyMhz(PM_MIN_FREQ_MHZ);
+#endif
+  }
+
+  /**
+   * @brief 进入阶段：按策略申请锁
+   */
+  static void enter(uint8_t phase) {
+#if ENABLE_POWER_MANAGEMENT
+    PowerPolicy policy = policyFor(phase);
+    if (pmActive) {
+      if (policy >= PM_AWAKE) esp_pm_lock_acquire(noSleepLock);
+      if (policy == PM_FULL) esp_pm_lock_acquire(cpuMaxLock);
+    } else if (policy == PM_FULL && manualMutex) {
+      xSemaphoreTake(manualMutex, portMAX_DELAY);
+      if (manualFullCount++ == 0) setCpuFrequencyMhz(PM_MAX_FREQ_MHZ);
+      xSemaphoreGive(manualMutex);
+    }
+#endif
+  }
+
+  /**
+   * @brief 离开阶段：释放 enter() 申请的锁
+   */
+  static void exit(uint8_t phase) {
+#if ENABLE_POWER_MANAGEMENT
+    PowerPolicy policy = policyFor(phase);
+    if (pmActive) {
+      if (policy == PM_FULL) esp_pm_lock_release(cpuMaxLock);
+      if (policy >= PM_AWAKE) esp_pm_lock_release(noSleepLock);
+    } else if (policy == PM_FULL && manualMutex) {
+      xSemaphoreTake(manualMutex, portMAX_DELAY);
+      if (manualFullCount > 0 && --manualFullCount == 0) setCpuFrequencyMhz(PM_MIN_FREQ_MHZ);
+      xSemaphoreGive(manualMutex);
+    }
+#endif
+  }
+};
+
+// 静态成员初始化
+bool PowerManager::pmActive = false;
+esp_pm_lock_handle_t PowerManager::cpuMaxLock = nullptr;
+esp_pm_lock_handle_t PowerManager::noSleepLock = nullptr;
+SemaphoreHandle_t PowerManager::manualMutex = nullptr;
+uint8_t PowerManager::manualFullCount = 0;
@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * @file RtcClock.h
+ * @brief RTC 时钟读取（系统时间由 RTC 定时器维持，深度睡眠与软复位后连续，断电归零）
+ */
+
+#include <stdint.h>
+#include <sys/time.h>
+
+#ifdef RTC_CLOCK_MOCK
+// 主机端测试（native 环境）由测试代码推进时钟
+extern uint32_t g_mockRtcSeconds;
+inline uint32_t rtcNowSeconds() { return g_mockRtcSeconds; }
+#else
+/**
+ * @brief 当前 RTC 时钟秒数
+ */
+inline uint32_t rtcNowSeconds() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (uint32_t)tv.tv_sec;
+}
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * @file SampleBatch.h
+ * @brief 多次唤醒的心跳采样批量缓存（RTC 内存）
+ *
+ * 每次唤醒只采样（倾角/分贝/电压）并写入 RTC 环形缓冲，
+ * 累计 HB_BATCH_SIZE 次才联网一次，把所有样本放在同一个心跳里上报；
+ * 报警时立即随报警会话一起发出。无线关联是单次唤醒中最耗电的部分，
+ * 批量上报把这部分开销分摊到 K 个样本上。
+ *
+ * 紧凑格式（并入 StatusPayload 的 "samples" 字段）:
+ *   {"t0":<首样本RTC秒>,"dt":[相对秒...],"a":[倾角×100...],
+ *    "db":[分贝×10...],"mv":[电压mV...]}
+ */
+
+#include "../../include/AppConfig.h"
+#include "RtcClock.h"
+
+/**
+ * @brief 单个样本（定点存储，10 字节）
+ */
+struct HeartbeatSample {
+  uint32_t t;       // RTC 秒
+  int16_t angleCd;  // 倾角 ×100 (°)
+  int16_t dbDd;     // 分贝 ×10 (dB)
+  uint16_t mv;      // 电池电压 (mV)
+};
+
+/**
+ * @brief RTC 环形缓冲（定义于 main.cpp）
+ */
+struct SampleBatchState {
+  uint32_t magic;
+  uint8_t head;   // 下一个写入位置
+  uint8_t count;  // 有效样本数
+  HeartbeatSample samples[HB_BATCH_CAPACITY];
+};
+
+class SampleBatch {
+private:
+  static const uint32_t BATCH_MAGIC = 0x48425443; // "HBTC"
+
+  static SampleBatchState state; // RTC 内存（定义于 main.cpp）
+
+public:
+  /**
+   * @brief 追加一个样本（满时覆盖最旧样本）
+   */
+  static void add(float angle, float soundDb, float voltage) {
+    ensureState();
+    HeartbeatSample &s = state.samples[state.head];
+    s.t = rtcNowSeconds();
+    s.angleCd = (int16_t)constrain(angle * 100.0f, -32768.0f, 32767.0f);
+    s.dbDd = (int16_t)constrain(soundDb * 10.0f, -32768.0f, 32767.0f);
+    s.mv = (uint16_t)constrain(voltage * 1000.0f, 0.0f, 65535.0f);
+
+    state.head = (state.head + 1) % HB_BATCH_CAPACITY;
+    if (state.count < HB_BATCH_CAPACITY) state.count++;
+
+    DEBUG_PRINTF("[批量] 样本 %u/%u\n", state.count, HB_BATCH_SIZE);
+  }
+
+  static uint8_t count() {
+    ensureState();
+    return state.count;
+  }
+
+  /**
+   * @brief 是否已累计够一批
+   */
+  static bool isUploadDue() { return count() >= HB_BATCH_SIZE; }
+
+  static void clear() {
+    ensureState();
+    state.head = 0;
+    state.count = 0;
+  }
+
+  /**
+   * @brief 生成紧凑 JSON（按时间顺序）
+   */
+  static String toJson() {
+    ensureState();
+    if (state.count == 0) return String();
+
+    uint8_t first = (state.head + HB_BATCH_CAPACITY - state.count) % HB_BATCH_CAPACITY;
+    uint32_t t0 = state.samples[first].t;
+
+    String dt, a, db, mv;
+    for (uint8_t i = 0; i < state.count; i++) {
+      const HeartbeatSample &s = state.samples[(first + i) % HB_BATCH_CAPACITY];
+      const char *sep = i ? "," : "";
+      dt += sep; dt += (unsigned long)(s.t - t0);
+      a += sep;  a += (int)s.angleCd;
+      db += sep; db += (int)s.dbDd;
+      mv += sep; mv += (unsigned)s.mv;
+    }
+
+    String json = "{\"t0\":";
+    json += (unsigned long)t0;
+    json += ",\"dt\":[" + dt + "],\"a\":[" + a + "],\"db\":[" + db +
+            "],\"mv\":[" + mv + "]}";
+    return json;
+  }
+
+private:
+  static void ensureState() {
+    if (state.magic != BATCH_MAGIC || state.head >= HB_BATCH_CAPACITY ||
+        state.count > HB_BATCH_CAPACITY) {
+      memset(&state, 0, sizeof(state));
+      state.magic = BATCH_MAGIC;
+    }
+  }
+};
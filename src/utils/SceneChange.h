@@ -0,0 +1,134 @@
+#pragma once
+
+/**
+ * @file SceneChange.h
+ * @brief 画面变化检测 - 与 LittleFS 中的参考灰度图逐块比较，画面未变时不重复上传照片
+ *
+ * 持续报警时每个 SLEEP_DURATION_ALARM 都会拍到几乎相同的画面。这里把照片按
+ * SCENE_DECODE_SCALE 降采样解码（QVGA 1/8 → 40x30，只用到 DCT 直流分量，几乎
+ * 不花时间），每个像素即原图一个 8x8 块的均值，与参考图比较:
+ *   1. 两图各自减去全图均值，抵消自动曝光带来的整体明暗变化
+ *   2. 块差 |cur - curMean - (ref - refMean)| > SCENE_BLOCK_DIFF 记为变化块
+ *   3. 变化块占比 >= SCENE_CHANGE_MIN_PCT 视为画面已变
+ *
+ * 参考图只在画面已变（或尚无参考/尺寸不符）且照片上传成功后替换
+ * (commitReference)，因此缓慢的累积变化最终也会越过阈值，断网时也不会
+ * 把服务器从未收到的画面当作参考。
+ *
+ * 存储格式 SCENE_REF_PATH: magic(u32) width(u16) height(u16) 像素(width×height)
+ */
+
+#include "../../include/AppConfig.h"
+#include "FlashFs.h"
+#include "JpegGray.h"
+#include <LittleFS.h>
+
+class SceneChange {
+private:
+  static const uint32_t REF_MAGIC = 0x53434E52; // "SCNR"
+  static JpegGray::Image pending; // 待上传成功后写入的新参考图
+
+  static bool loadReference(JpegGray::Image &ref) {
+    File f = LittleFS.open(SCENE_REF_PATH, FILE_READ);
+    if (!f) return false;
+    uint32_t magic = 0;
+    uint16_t w = 0, h = 0;
+    bool ok = f.read((uint8_t *)&magic, 4) == 4 && f.read((uint8_t *)&w, 2) == 2 &&
+              f.read((uint8_t *)&h, 2) == 2 && magic == REF_MAGIC &&
+              f.size() == 8 + (size_t)w * h;
+    if (ok) {
+      ref.pixels = (uint8_t *)heap_caps_malloc((size_t)w * h, MALLOC_CAP_SPIRAM);
+      ref.width = w;
+      ref.height = h;
+      ok = ref.pixels && f.read(ref.pixels, (size_t)w * h) == (size_t)w * h;
+    }
+    f.close();
+    if (!ok) JpegGray::release(ref);
+    return ok;
+  }
+
+  static void saveReference(const JpegGray::Image &img) {
+    File f = LittleFS.open(SCENE_REF_PATH, FILE_WRITE);
+    if (!f) {
+      DEBUG_PRINTLN("[画面] ⚠️ 参考图写入失败");
+      return;
+    }
+    uint32_t magic = REF_MAGIC;
+    uint16_t w = img.width, h = img.height;
+    f.write((const uint8_t *)&magic, 4);
+    f.write((const uint8_t *)&w, 2);
+    f.write((const uint8_t *)&h, 2);
+    f.write(img.pixels, (size_t)w * h);
+    f.close();
+  }
+
+public:
+  /**
+   * @brief 变化块占比 (%)，两图须同尺寸
+   * @note 只有累加与比较的直线循环，编译器可自动向量化
+   */
+  static int changedPercent(const uint8_t *cur, const uint8_t *ref, size_t n) {
+    if (n == 0) return 100;
+    uint32_t sumCur = 0, sumRef = 0;
+    for (size_t i = 0; i < n; i++) {
+      sumCur += cur[i];
+      sumRef += ref[i];
+    }
+    int offset = (int)(sumCur / n) - (int)(sumRef / n); // 整体明暗差
+
+    size_t changed = 0;
+    for (size_t i = 0; i < n; i++) {
+      int diff = (int)cur[i] - (int)ref[i] - offset;
+      changed += (diff > SCENE_BLOCK_DIFF || diff < -SCENE_BLOCK_DIFF);
+    }
+    return (int)(changed * 100 / n);
+  }
+
+  /**
+   * @brief 新照片与参考图比较，画面已变时暂存为待定参考图
+   * @return true=画面已变（或无法判断），应正常上传
+   */
+  static bool check(const uint8_t *jpeg, size_t len) {
+#if ENABLE_SCENE_CHANGE
+    discardReference();
+    JpegGray::Image cur, ref;
+    if (!FlashFs::mount() || !JpegGray::decode(jpeg, len, SCENE_DECODE_SCALE, cur)) {
+      return true;
+    }
+
+    bool changed = true;
+    if (loadReference(ref) && ref.width == cur.width && ref.height == cur.height) {
+      int pct = changedPercent(cur.pixels, ref.pixels, (size_t)cur.width * cur.height);
+      changed = pct >= SCENE_CHANGE_MIN_PCT;
+      DEBUG_PRINTF("[画面] 变化块 %d%%（阈值 %d%%）→ %s\n", pct, SCENE_CHANGE_MIN_PCT,
+                   changed ? "已变化" : "未变化");
+    } else {
+      DEBUG_PRINTLN("[画面] 无参考图，建立参考");
+    }
+
+    if (changed) {
+      pending = cur;
+    } else {
+      JpegGray::release(cur);
+    }
+    JpegGray::release(ref);
+    return changed;
+#else
+    return true;
+#endif
+  }
+
+  /**
+   * @brief 照片已上传，待定参考图生效
+   */
+  static void commitReference() {
+    if (!pending.pixels) return;
+    saveReference(pending);
+    JpegGray::release(pending);
+  }
+
+  static void discardReference() { JpegGray::release(pending); }
+};
+
+// 静态成员初始化
+JpegGray::Image SceneChange::pending;
@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * @file Sharpness.h
+ * @brief 图像清晰度评分 - 灰度图拉普拉斯方差
+ *
+ * 对降采样灰度图做 4 邻域拉普拉斯:
+ *   L(x,y) = 4·I(x,y) - I(x-1,y) - I(x+1,y) - I(x,y-1) - I(x,y+1)
+ * 得分为 L 的方差。运动模糊抹平边缘、欠曝/过曝压缩对比度，都会使得分下降，
+ * 因此同一场景连拍的几帧中得分最高者即最清晰、曝光最合适的一帧。
+ *
+ * 弱光下传感器增益高，像素噪声同样使拉普拉斯方差升高，原始方差会把
+ * "噪点多"误判为"清晰"。score() 用 Immerkaer 快速噪声估计
+ * （掩模 [1 -2 1; -2 4 -2; 1 -2 1] 对边缘近乎不响应）得到噪声标准差 σ，
+ * 白噪声对 4 邻域拉普拉斯方差的贡献为 20σ²，从方差中扣除后再比较。
+ *
+ * @note 得分只在同一场景、同一分辨率的帧之间可比
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Sharpness {
+public:
+  /**
+   * @brief 拉普拉斯方差
+   * @param gray 灰度图（行优先）
+   * @param w,h  宽高，小于 3 时返回 0
+   */
+  static float laplacianVariance(const uint8_t *gray, int w, int h) {
+    if (!gray || w < 3 || h < 3) return 0.0f;
+
+    int64_t sum = 0;
+    int64_t sumSq = 0;
+    for (int y = 1; y < h - 1; y++) {
+      const uint8_t *row = gray + (size_t)y * w;
+      for (int x = 1; x < w - 1; x++) {
+        int lap = 4 * row[x] - row[x - 1] - row[x + 1] - row[x - w] - row[x + w];
+        sum += lap;
+        sumSq += (int64_t)lap * lap;
+      }
+    }
+
+    double n = (double)(w - 2) * (h - 2);
+    double mean = sum / n;
+    return (float)(sumSq / n - mean * mean);
+  }
+
+  /**
+   * @brief 噪声标准差估计（Immerkaer 1996）
+   * @param gray 灰度图（行优先）
+   * @param w,h  宽高，小于 3 时返回 0
+   */
+  static float noiseSigma(const uint8_t *gray, int w, int h) {
+    if (!gray || w < 3 || h < 3) return 0.0f;
+
+    int64_t sumAbs = 0;
+    for (int y = 1; y < h - 1; y++) {
+      const uint8_t *up = gray + (size_t)(y - 1) * w;
+      const uint8_t *row = up + w;
+      const uint8_t *down = row + w;
+      for (int x = 1; x < w - 1; x++) {
+        int v = up[x - 1] - 2 * up[x] + up[x + 1] - 2 * row[x - 1] + 4 * row[x] -
+                2 * row[x + 1] + down[x - 1] - 2 * down[x] + down[x + 1];
+        sumAbs += v < 0 ? -v : v;
+      }
+    }
+
+    double n = (double)(w - 2) * (h - 2);
+    return (float)(1.2533141 * sumAbs / (6.0 * n)); // sqrt(π/2) · Σ|I*N| / 6n
+  }
+
+  /**
+   * @brief 清晰度得分：拉普拉斯方差扣除噪声贡献 (20σ²)，不小于 0
+   */
+  static float score(const uint8_t *gray, int w, int h) {
+    float sigma = noiseSigma(gray, w, h);
+    float s = laplacianVariance(gray, w, h) - 20.0f * sigma * sigma;
+    return s > 0.0f ? s : 0.0f;
+  }
+};
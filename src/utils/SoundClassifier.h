@@ -0,0 +1,220 @@
+#pragma once
+
+/**
+ * @file SoundClassifier.h
+ * @brief 频谱特征 + 最近原型分类 - 在拍照上传前区分机械噪音与风/雨/交通
+ *
+ * 特征提取（仅在 Leq 超过阈值后调用一次）:
+ *   - 窗口按 SOUND_FFT_SIZE 点、50% 重叠分帧，Hann 窗 + 基 2 FFT，功率谱取平均
+ *   - 频带能量占比：SOUND_BAND_EDGES_HZ 划分的 4 个频带
+ *   - 频谱质心 (Hz) 与频谱平坦度（几何均值/算术均值，0=纯音 1=白噪）
+ *
+ * 分类:
+ *   - 原型表 PROTOTYPES 在编译期给定，每类可有多个原型
+ *   - 距离 = 频带占比差 + 质心对数差 + 平坦度差（欧氏距离）
+ *   - 最近原型距离超过 SOUND_CLASS_MAX_DISTANCE 时判为 SOUND_UNKNOWN
+ *   - SOUND_SUPPRESS_MASK 中的类别不触发报警；UNKNOWN 永不抑制（宁可误报）
+ */
+
+#include "../../include/AppConfig.h"
+#include <math.h>
+
+enum SoundClass : uint8_t {
+  SOUND_UNKNOWN = 0,
+  SOUND_MACHINERY, // 油锯、挖掘机等（谐波明显，平坦度低）
+  SOUND_WIND,      // 低频宽带
+  SOUND_RAIN,      // 高频宽带
+  SOUND_TRAFFIC,   // 中低频宽带
+  SOUND_CLASS_COUNT
+};
+
+#define SOUND_BAND_COUNT 4
+
+/**
+ * @brief 频谱特征
+ */
+struct SpectralFeatures {
+  float band[SOUND_BAND_COUNT] = {}; // 各频带能量占比
+  float centroidHz = 0.0f;           // 频谱质心
+  float flatness = 0.0f;             // 频谱平坦度
+};
+
+class SoundClassifier {
+private:
+  struct Prototype {
+    SoundClass cls;
+    float band[SOUND_BAND_COUNT];
+    float centroidHz;
+    float flatness;
+  };
+
+  // 原型表（频带: <250 / 250-1k / 1k-4k / >4k Hz）
+  static constexpr Prototype PROTOTYPES[] = {
+      {SOUND_MACHINERY, {0.15f, 0.40f, 0.40f, 0.05f}, 1300.0f, 0.30f}, // 油锯
+      {SOUND_MACHINERY, {0.45f, 0.40f, 0.13f, 0.02f}, 350.0f, 0.25f},  // 挖掘机/发动机
+      {SOUND_WIND, {0.75f, 0.18f, 0.06f, 0.01f}, 200.0f, 0.85f},
+      {SOUND_RAIN, {0.05f, 0.15f, 0.40f, 0.40f}, 3500.0f, 0.85f},
+      {SOUND_TRAFFIC, {0.40f, 0.38f, 0.18f, 0.04f}, 800.0f, 0.85f},
+  };
+
+  static const size_t N = SOUND_FFT_SIZE;
+  static const size_t BINS = N / 2;
+
+  float re[N];
+  float im[N];
+  float hann[N];
+  float cosTable[N / 2];
+  float sinTable[N / 2];
+  float power[BINS];
+  bool tablesReady = false;
+
+  void buildTables() {
+    for (size_t i = 0; i < N; i++) {
+      hann[i] = 0.5f - 0.5f * cosf(2.0f * PI * i / (N - 1));
+    }
+    for (size_t i = 0; i < N / 2; i++) {
+      cosTable[i] = cosf(2.0f * PI * i / N);
+      sinTable[i] = -sinf(2.0f * PI * i / N);
+    }
+    tablesReady = true;
+  }
+
+  /**
+   * @brief 原地基 2 FFT（re/im）
+   */
+  void fft() {
+    for (size_t i = 1, j = 0; i < N; i++) {
+      size_t bit = N >> 1;
+      for (; j & bit; bit >>= 1) j ^= bit;
+      j ^= bit;
+      if (i < j) {
+        float t = re[i]; re[i] = re[j]; re[j] = t;
+        t = im[i]; im[i] = im[j]; im[j] = t;
+      }
+    }
+    for (size_t len = 2; len <= N; len <<= 1) {
+      size_t half = len / 2, stride = N / len;
+      for (size_t i = 0; i < N; i += len) {
+        for (size_t k = 0; k < half; k++) {
+          float wr = cosTable[k * stride], wi = sinTable[k * stride];
+          size_t a = i + k, b = a + half;
+          float tr = re[b] * wr - im[b] * wi;
+          float ti = re[b] * wi + im[b] * wr;
+          re[b] = re[a] - tr;
+          im[b] = im[a] - ti;
+          re[a] += tr;
+          im[a] += ti;
+        }
+      }
+    }
+  }
+
+  static float distance(const SpectralFeatures &f, const Prototype &p) {
+    float d = 0.0f;
+    for (int i = 0; i < SOUND_BAND_COUNT; i++) {
+      float diff = f.band[i] - p.band[i];
+      d += diff * diff;
+    }
+    // 质心按倍频程比较，4 个倍频程 ≈ 1
+    float c = log2f(max(f.centroidHz, 1.0f) / p.centroidHz) / 4.0f;
+    float fl = f.flatness - p.flatness;
+    return sqrtf(d + c * c + fl * fl);
+  }
+
+public:
+  /**
+   * @brief 从 12 位原始样本窗口提取频谱特征
+   * @return false=样本不足一帧
+   */
+  bool extract(const uint16_t *samples, size_t count, uint32_t sampleRateHz,
+               SpectralFeatures &out) {
+    if (count < N) return false;
+    if (!tablesReady) buildTables();
+
+    uint32_t sum = 0;
+    for (size_t i = 0; i < count; i++) sum += samples[i];
+    float mean = (float)sum / count;
+
+    memset(power, 0, sizeof(power));
+    size_t frames = 0;
+    for (size_t start = 0; start + N <= count; start += N / 2, frames++) {
+      for (size_t i = 0; i < N; i++) {
+        re[i] = (samples[start + i] - mean) * hann[i];
+        im[i] = 0.0f;
+      }
+      fft();
+      for (size_t k = 0; k < BINS; k++) {
+        power[k] += re[k] * re[k] + im[k] * im[k];
+      }
+    }
+
+    static const float EDGES[SOUND_BAND_COUNT - 1] = SOUND_BAND_EDGES_HZ;
+    float binHz = (float)sampleRateHz / N;
+    float total = 0.0f, weighted = 0.0f;
+    out = SpectralFeatures();
+    for (size_t k = 1; k < BINS; k++) { // 跳过直流
+      float p = power[k] / frames + 1e-6f;
+      power[k] = p;
+      float hz = k * binHz;
+      int band = 0;
+      while (band < SOUND_BAND_COUNT - 1 && hz >= EDGES[band]) band++;
+      out.band[band] += p;
+      total += p;
+      weighted += p * hz;
+    }
+
+    // 平坦度按倍频程分段计算再按能量加权，避免整体频谱倾斜（风/交通）被误判为音调
+    float flatWeighted = 0.0f, flatEnergy = 0.0f;
+    for (size_t lo = 4; lo < BINS; lo <<= 1) {
+      size_t hi = (lo << 1) < BINS ? (lo << 1) : BINS;
+      float energy = 0.0f, logSum = 0.0f;
+      for (size_t k = lo; k < hi; k++) {
+        energy += power[k];
+        logSum += logf(power[k]);
+      }
+      size_t n = hi - lo;
+      flatWeighted += energy * expf(logSum / n) / (energy / n);
+      flatEnergy += energy;
+    }
+
+    for (int i = 0; i < SOUND_BAND_COUNT; i++) out.band[i] /= total;
+    out.centroidHz = weighted / total;
+    out.flatness = flatEnergy > 0.0f ? flatWeighted / flatEnergy : 0.0f;
+    return true;
+  }
+
+  /**
+   * @brief 最近原型分类
+   */
+  static SoundClass classify(const SpectralFeatures &f) {
+    SoundClass best = SOUND_UNKNOWN;
+    float bestDist = SOUND_CLASS_MAX_DISTANCE;
+    for (const Prototype &p : PROTOTYPES) {
+      float d = distance(f, p);
+      if (d < bestDist) {
+        bestDist = d;
+        best = p.cls;
+      }
+    }
+    DEBUG_PRINTF("[声音分类] 频带=%.2f/%.2f/%.2f/%.2f 质心=%.0fHz 平坦度=%.2f → %s (%.2f)\n",
+                 f.band[0], f.band[1], f.band[2], f.band[3], f.centroidHz, f.flatness,
+                 label(best), bestDist);
+    return best;
+  }
+
+  /**
+   * @brief 该类别是否应抑制噪音报警
+   */
+  static bool isSuppressed(uint8_t cls) {
+    return cls != SOUND_UNKNOWN && cls < SOUND_CLASS_COUNT &&
+           (SOUND_SUPPRESS_MASK & (1u << cls)) != 0;
+  }
+
+  static const char *label(uint8_t cls) {
+    static const char *const LABELS[SOUND_CLASS_COUNT] = {
+        "unknown", "machinery", "wind", "rain", "traffic"};
+    return cls < SOUND_CLASS_COUNT ? LABELS[cls] : "unknown";
+  }
+};
+
+constexpr SoundClassifier::Prototype SoundClassifier::PROTOTYPES[];
@@ -0,0 +1,153 @@
+#pragma once
+
+/**
+ * @file SoundLevelMeter.h
+ * @brief 定点声级计 - 去直流 + A 计权 + RMS，输出 Leq / Lmax (dB(A))
+ *
+ * 处理流程（每个采样窗口）:
+ *   1. 去直流：减去窗口均值，样本左移 LEVEL_SHIFT 位放大到 ±32768 量级
+ *   2. A 计权：3 节二阶 IIR (DF1)，Q29 系数，int64 累加
+ *   3. 跳过前 AUDIO_LEVEL_SETTLE_SAMPLES 个样本（滤波器建立期）
+ *   4. 按 AUDIO_LEVEL_SUBWINDOW_SAMPLES 分段求均方值:
+ *        Leq  = 全窗口能量平均
+ *        Lmax = 各子窗口中的最大值
+ *
+ * 设计说明:
+ *   - 报警判定比较 Leq 均方值与 begin() 中预计算的均方阈值，纯整数比较；
+ *     log10 仅在生成上报用的 dB 值时每窗口调用两次
+ *   - 单个尖峰在 Leq 中按能量摊薄，不再像峰峰值那样直接决定读数
+ *   - 滤波器系数在 begin() 中按采样率用双线性变换计算，每节在 1 kHz 归一为
+ *     0 dB；16 kHz 下 12.2 kHz 极点超出奈奎斯特频率，6 kHz 以上略有偏差
+ *   - dB(A) = 10·log10(均方计数²) + AUDIO_DBA_OFFSET，偏移需用声级计校准
+ */
+
+#include "../../include/AppConfig.h"
+#include <math.h>
+
+/**
+ * @brief 单个窗口的测量结果
+ */
+struct SoundLevel {
+  float leqDb = 0.0f;       // 等效连续声级 dB(A)
+  float lmaxDb = 0.0f;      // 最大子窗口声级 dB(A)
+  uint32_t leqSquare = 0;   // Leq 均方值（放大后的计数²）
+  bool overThreshold = false;
+};
+
+class SoundLevelMeter {
+private:
+  static const int COEF_Q = 29;     // 系数定点格式 Q29（范围 ±4）
+  static const int LEVEL_SHIFT = 4; // 12 位样本放大 16 倍
+
+  struct Biquad {
+    int32_t b0, b1, b2, a1, a2;
+    int32_t x1, x2, y1, y2;
+  };
+
+  Biquad sections[3] = {};
+  uint32_t thresholdSquare = UINT32_MAX; // 报警阈值对应的均方值
+
+  /**
+   * @brief 由两个模拟实极点设计一节二阶滤波器，并在 1 kHz 归一化
+   * @param highPass true=两个零点在 s=0（高通），false=零点在奈奎斯特频率（低通）
+   */
+  static void design(Biquad &bq, double fs, double p1, double p2, bool highPass) {
+    double k = 2.0 * fs;
+    double c1 = (p1 - k) / (p1 + k);
+    double c2 = (p2 - k) / (p2 + k);
+    double a1 = c1 + c2;
+    double a2 = c1 * c2;
+    double b1 = highPass ? -2.0 : 2.0;
+
+    // |H(e^jw)| @ 1 kHz
+    double w = 2.0 * PI * 1000.0 / fs;
+    double nr = 1.0 + b1 * cos(w) + cos(2 * w), ni = -(b1 * sin(w) + sin(2 * w));
+    double dr = 1.0 + a1 * cos(w) + a2 * cos(2 * w), di = -(a1 * sin(w) + a2 * sin(2 * w));
+    double g = sqrt((dr * dr + di * di) / (nr * nr + ni * ni));
+
+    const double scale = (double)(1L << COEF_Q);
+    bq = {};
+    bq.b0 = (int32_t)lround(g * scale);
+    bq.b1 = (int32_t)lround(g * b1 * scale);
+    bq.b2 = bq.b0;
+    bq.a1 = (int32_t)lround(a1 * scale);
+    bq.a2 = (int32_t)lround(a2 * scale);
+  }
+
+  static inline int32_t step(Biquad &s, int32_t x) {
+    int64_t acc = (int64_t)s.b0 * x + (int64_t)s.b1 * s.x1 + (int64_t)s.b2 * s.x2 -
+                  (int64_t)s.a1 * s.y1 - (int64_t)s.a2 * s.y2;
+    int32_t y = (int32_t)(acc >> COEF_Q);
+    s.x2 = s.x1;
+    s.x1 = x;
+    s.y2 = s.y1;
+    s.y1 = y;
+    return y;
+  }
+
+  static float toDb(uint64_t square) {
+    if (square == 0) return 0.0f;
+    // 放大后的计数² → 原始计数²
+    float counts = (float)square / (float)(1UL << (2 * LEVEL_SHIFT));
+    return 10.0f * log10f(counts) + AUDIO_DBA_OFFSET;
+  }
+
+public:
+  /**
+   * @brief 计算滤波器系数与报警均方阈值
+   */
+  void begin(uint32_t sampleRateHz, float thresholdDb) {
+    // IEC 61672 A 计权模拟极点 (Hz)
+    const double f1 = 20.598997, f2 = 107.65265, f3 = 737.86223, f4 = 12194.217;
+    const double w = 2.0 * PI;
+    design(sections[0], sampleRateHz, w * f1, w * f1, true);
+    design(sections[1], sampleRateHz, w * f2, w * f3, true);
+    design(sections[2], sampleRateHz, w * f4, w * f4, false);
+
+    double square = pow(10.0, (thresholdDb - AUDIO_DBA_OFFSET) / 10.0) *
+                    (double)(1UL << (2 * LEVEL_SHIFT));
+    thresholdSquare = square >= (double)UINT32_MAX ? UINT32_MAX : (uint32_t)square;
+  }
+
+  /**
+   * @brief 处理一个窗口（12 位原始样本）
+   */
+  SoundLevel process(const uint16_t *samples, size_t count) {
+    SoundLevel level;
+    if (count <= AUDIO_LEVEL_SETTLE_SAMPLES) return level;
+
+    uint32_t sum = 0;
+    for (size_t i = 0; i < count; i++) sum += samples[i];
+    int32_t mean = (int32_t)(sum / count);
+
+    for (Biquad &s : sections) {
+      s.x1 = s.x2 = s.y1 = s.y2 = 0;
+    }
+
+    uint64_t total = 0, sub = 0, subMax = 0;
+    size_t measured = 0, subLen = 0;
+    for (size_t i = 0; i < count; i++) {
+      int32_t y = ((int32_t)samples[i] - mean) << LEVEL_SHIFT;
+      for (Biquad &s : sections) y = step(s, y);
+      if (i < AUDIO_LEVEL_SETTLE_SAMPLES) continue;
+
+      uint64_t sq = (uint64_t)((int64_t)y * y);
+      total += sq;
+      sub += sq;
+      measured++;
+      if (++subLen == AUDIO_LEVEL_SUBWINDOW_SAMPLES) {
+        if (sub / subLen > subMax) subMax = sub / subLen;
+        sub = 0;
+        subLen = 0;
+      }
+    }
+    if (subLen > 0 && sub / subLen > subMax) subMax = sub / subLen;
+
+    uint64_t leq = total / measured;
+    level.leqSquare = leq > UINT32_MAX ? UINT32_MAX : (uint32_t)leq;
+    level.overThreshold = level.leqSquare > thresholdSquare;
+    level.leqDb = toDb(leq);
+    level.lmaxDb = toDb(subMax);
+    return level;
+  }
+};
@@ -0,0 +1,256 @@
+#pragma once
+
+/**
+ * @file TelemetryQueue.h
+ * @brief 断网缓存队列 - LittleFS 上的追加写记录队列，联网后批量补发
+ *
+ * 存储格式（default_8MB.csv 的 spiffs 分区，以 LittleFS 挂载）:
+ *   /tq.log  每行一条记录: {"t":<RTC秒>,"d":<原始 JSON>}
+ *   /tq.off  已确认发送的读偏移（十进制文本）
+ *
+ * 批量补发格式（经 sendStatus 一次请求发出）:
+ *   {"type":"BATCH","device_id":"POLE_001","now":<RTC秒>,"records":[...]}
+ *
+ * 设计说明:
+ *   - 只追加、不原地修改，掉电最多丢失正在写的一行：追加前若文件末尾不是换行
+ *     先补一个，补发时跳过不完整的行，残行不会与下一条记录粘连或阻塞队列
+ *   - 偏移在每批发送成功后才提交，失败时下次从原位置重发
+ *   - 全部发完后删除两个文件；超过 TQ_MAX_BYTES 时压缩并丢弃最旧记录
+ */
+
+#include "../../include/AppConfig.h"
+#include "../interfaces/IComm.h"
+#include "FlashFs.h"
+#include "RtcClock.h"
+#include <LittleFS.h>
+
+class TelemetryQueue {
+public:
+  /**
+   * @brief 挂载文件系统（首次使用时自动格式化）
+   */
+  static bool begin() { return FlashFs::mount(); }
+
+  /**
+   * @brief 追加一条记录
+   * @param json 完整的 JSON 对象字符串
+   * @return true=整行已写入（空间不足导致的短写返回 false，残行由 drain 跳过）
+   */
+  static bool push(const char *json) {
+    if (!begin()) return false;
+
+    bool torn = endsWithoutNewline();
+    File f = LittleFS.open(TQ_LOG_PATH, FILE_APPEND, true);
+    if (!f) {
+      DEBUG_PRINTLN("[队列] ❌ 打开失败");
+      return false;
+    }
+    if (torn) f.print('\n'); // 上次追加时掉电留下的残行
+    String line = String("{\"t\":") + (unsigned long)rtcNowSeconds() + ",\"d\":" + json + "}\n";
+    bool written = f.print(line) == line.length();
+    size_t size = f.size();
+    f.close();
+    if (!written) {
+      DEBUG_PRINTLN("[队列] ❌ 写入不完整（空间不足？）");
+      return false;
+    }
+
+    DEBUG_PRINTF("[队列] 📥 已缓存 (待发 %lu bytes)\n",
+                 (unsigned long)(size - readOffset()));
+
+    if (size > TQ_MAX_BYTES) {
+      compact();
+    }
+    return true;
+  }
+
+  /**
+   * @brief 待发送字节数
+   */
+  static size_t pendingBytes() {
+    if (!begin() || !LittleFS.exists(TQ_LOG_PATH)) return 0;
+    File f = LittleFS.open(TQ_LOG_PATH, FILE_READ);
+    if (!f) return 0;
+    size_t size = f.size();
+    f.close();
+    uint32_t offset = readOffset();
+    return size > offset ? size - offset : 0;
+  }
+
+  static bool isEmpty() { return pendingBytes() == 0; }
+
+  /**
+   * @brief 批量补发（需已联网）
+   * @param commModule 已连接的通信模块
+   * @param outResponse 最后一批的服务器响应（可选）
+   * @param maxResponseLen 响应缓冲区长度
+   * @return true=队列已清空
+   */
+  static bool drain(IComm *commModule, char *outResponse = nullptr,
+                    size_t maxResponseLen = 0) {
+    if (isEmpty()) return true;
+
+    File f = LittleFS.open(TQ_LOG_PATH, FILE_READ);
+    if (!f) return false;
+    size_t size = f.size();
+    uint32_t offset = readOffset();
+
+    for (uint8_t batch = 0; batch < TQ_MAX_BATCHES_PER_SESSION && offset < size; batch++) {
+      String body;
+      body.reserve(TQ_BATCH_MAX_BYTES + 128);
+      body += "{\"type\":\"BATCH\",\"device_id\":\"";
+      body += HTTP_DEVICE_ID;
+      body += "\",\"now\":";
+      body += (unsigned long)rtcNowSeconds();
+      body += ",\"records\":[";
+
+      f.seek(offset, SeekSet);
+      uint32_t next = offset;
+      uint16_t records = 0;
+      while (next < size) {
+        String line = f.readStringUntil('\n');
+        uint32_t lineBytes = line.length() + 1;
+        // 单条超长也至少发送一条，避免卡死
+        if (records > 0 && body.length() + line.length() > TQ_BATCH_MAX_BYTES) break;
+        next += lineBytes;
+        if (line.length() == 0) continue;
+        if (!isCompleteRecord(line)) {
+          DEBUG_PRINTF("[队列] ⚠️ 跳过不完整记录 (%u bytes)\n", line.length());
+          continue;
+        }
+        if (records > 0) body += ',';
+        body += line;
+        records++;
+      }
+      body += "]}";
+
+      if (records == 0) {
+        offset = next;
+        writeOffset(offset);
+        continue;
+      }
+
+      DEBUG_PRINTF("[队列] 📤 补发第 %u 批: %u 条, %u bytes\n", batch + 1,
+                   records, body.length());
+      if (!commModule->sendStatus(body.c_str(), outResponse, maxResponseLen)) {
+        DEBUG_PRINTLN("[队列] ⚠️ 补发失败，保留待下次");
+        break;
+      }
+      offset = next;
+      writeOffset(offset);
+    }
+    f.close();
+
+    if (offset >= size) {
+      clear();
+      DEBUG_PRINTLN("[队列] ✓ 已清空");
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 清空队列
+   */
+  static void clear() {
+    if (!begin()) return;
+    LittleFS.remove(TQ_LOG_PATH);
+    LittleFS.remove(TQ_OFFSET_PATH);
+  }
+
+private:
+  static uint32_t readOffset() {
+    if (!LittleFS.exists(TQ_OFFSET_PATH)) return 0;
+    File f = LittleFS.open(TQ_OFFSET_PATH, FILE_READ);
+    if (!f) return 0;
+    uint32_t offset = (uint32_t)f.readStringUntil('\n').toInt();
+    f.close();
+    return offset;
+  }
+
+  /**
+   * @brief 日志文件非空且最后一个字节不是换行
+   */
+  static bool endsWithoutNewline() {
+    if (!LittleFS.exists(TQ_LOG_PATH)) return false;
+    File f = LittleFS.open(TQ_LOG_PATH, FILE_READ);
+    if (!f) return false;
+    bool torn = false;
+    size_t size = f.size();
+    if (size > 0 && f.seek(size - 1, SeekSet)) {
+      torn = f.read() != '\n';
+    }
+    f.close();
+    return torn;
+  }
+
+  /**
+   * @brief 是否为完整的 {"t":...} 记录：括号在最后一个字符处恰好闭合（忽略字符串内容）
+   */
+  static bool isCompleteRecord(const String &line) {
+    if (!line.startsWith("{\"t\":")) return false;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    for (size_t i = 0; i < line.length(); i++) {
+      char c = line[i];
+      if (inString) {
+        if (escaped) escaped = false;
+        else if (c == '\\') escaped = true;
+        else if (c == '"') inString = false;
+        continue;
+      }
+      if (c == '"') inString = true;
+      else if (c == '{' || c == '[') depth++;
+      else if (c == '}' || c == ']') {
+        if (--depth == 0) return i == line.length() - 1;
+      }
+    }
+    return false;
+  }
+
+  static void writeOffset(uint32_t offset) {
+    File f = LittleFS.open(TQ_OFFSET_PATH, FILE_WRITE, true);
+    if (!f) return;
+    f.printf("%lu\n", (unsigned long)offset);
+    f.close();
+  }
+
+  /**
+   * @brief 压缩：去掉已发送部分；仍超限则丢弃最旧记录至 3/4 容量
+   */
+  static void compact() {
+    File src = LittleFS.open(TQ_LOG_PATH, FILE_READ);
+    if (!src) return;
+    size_t size = src.size();
+    uint32_t offset = readOffset();
+
+    // 跳过最旧的记录，直到剩余部分不超过 3/4 容量
+    src.seek(offset, SeekSet);
+    uint32_t dropped = 0;
+    while (offset < size && size - offset > TQ_MAX_BYTES * 3 / 4) {
+      offset += src.readStringUntil('\n').length() + 1;
+      dropped++;
+    }
+
+    File dst = LittleFS.open(TQ_TMP_PATH, FILE_WRITE, true);
+    if (!dst) {
+      src.close();
+      return;
+    }
+    src.seek(offset, SeekSet);
+    uint8_t buf[256];
+    size_t n;
+    while ((n = src.read(buf, sizeof(buf))) > 0) {
+      dst.write(buf, n);
+    }
+    src.close();
+    dst.close();
+
+    LittleFS.remove(TQ_LOG_PATH);
+    LittleFS.rename(TQ_TMP_PATH, TQ_LOG_PATH);
+    LittleFS.remove(TQ_OFFSET_PATH);
+
+    DEBUG_PRINTF("[队列] 🗜️ 已压缩，丢弃最旧 %lu 条\n", (unsigned long)dropped);
+  }
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * @file TiltFusion.h
+ * @brief 陀螺仪 + 加速度计互补滤波 - 抑制风摆/车辆振动造成的假倾角
+ *
+ * 加速度计测得的是重力 + 线加速度，杆体晃动时 atan2 得到的角度会短时偏出数度；
+ * 陀螺仪积分不受线加速度影响但有零偏漂移。互补滤波取两者之长:
+ *   angle = α·(angle + rate·dt) + (1-α)·accelAngle,  α = τ / (τ + dt)
+ *
+ * 约定（与 LSM6DS3_Sensor::anglesFrom 一致，杆体近竖直时成立）:
+ *   pitch = atan2(ax, √(ay²+az²)) → 绕 Y 轴转动，pitch 变化率 = -gy
+ *   roll  = atan2(ay, √(ax²+az²)) → 绕 X 轴转动，roll 变化率 = +gx
+ *
+ * 当 |a| 偏离 1g 超过 TILT_FUSION_ACCEL_GATE_G 时该样本只做陀螺仪积分。
+ */
+
+#include "../../include/AppConfig.h"
+#include <math.h>
+
+class TiltFusion {
+private:
+  float pitch = 0.0f; // 度
+  float roll = 0.0f;  // 度
+
+public:
+  /**
+   * @brief 以加速度计角度作为初值
+   */
+  void reset(float pitchDeg, float rollDeg) {
+    pitch = pitchDeg;
+    roll = rollDeg;
+  }
+
+  /**
+   * @brief 输入一个样本
+   * @param ax,ay,az 加速度 (g)
+   * @param gx,gy    角速度，已扣除零偏 (°/s)
+   * @param dt       距上一样本的时间 (s)
+   */
+  void update(float ax, float ay, float az, float gx, float gy, float dt) {
+    pitch -= gy * dt;
+    roll += gx * dt;
+
+    float norm = sqrtf(ax * ax + ay * ay + az * az);
+    if (fabsf(norm - 1.0f) > TILT_FUSION_ACCEL_GATE_G) return;
+
+    float accelPitch = atan2f(ax, sqrtf(ay * ay + az * az)) * 180.0f / PI;
+    float accelRoll = atan2f(ay, sqrtf(ax * ax + az * az)) * 180.0f / PI;
+    float alpha = TILT_FUSION_TAU_S / (TILT_FUSION_TAU_S + dt);
+    pitch = alpha * pitch + (1.0f - alpha) * accelPitch;
+    roll = alpha * roll + (1.0f - alpha) * accelRoll;
+  }
+
+  float getPitch() const { return pitch; }
+  float getRoll() const { return roll; }
+};
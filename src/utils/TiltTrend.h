@@ -0,0 +1,173 @@
+#pragma once
+
+/**
+ * @file TiltTrend.h
+ * @brief 倾角缓慢蠕变检测 - 日均倾角滑动窗口线性回归（RTC 内存）
+ *
+ * 每周 0.1° 的缓慢倾斜在越过 TILT_THRESHOLD 之前不会触发任何报警。
+ * 这里把每次巡检的倾角累积成日均值，保留最近 TREND_WINDOW_DAYS 天，
+ * 并用增量最小二乘估计斜率:
+ *   slope = (n·Σxy - Σx·Σy) / (n·Σxx - (Σx)²)      x=日序号, y=日均倾角
+ *   预计到达阈值天数 = (TILT_THRESHOLD - 拟合当前值) / slope
+ * 新日均值入窗时加入累加量，窗口满时减去被挤出的一天，每次更新 O(1)。
+ *
+ * 预计天数 < TREND_HORIZON_DAYS 时发出 "creep" 报警，
+ * 之后 TREND_ALARM_COOLDOWN_DAYS 天内不重复。
+ *
+ * @note 与 NoiseFloor 相同，"日"取 RTC 时钟秒数 / 86400；断电后历史清空重新积累
+ */
+
+#include "../../include/AppConfig.h"
+#include "RtcClock.h"
+
+/**
+ * @brief RTC 状态（定义于 main.cpp）
+ */
+struct TiltTrendState {
+  uint32_t magic;
+  uint32_t baseDay;   // 回归 x 轴原点（第一个样本的日序号）
+  uint32_t day;       // 正在累积的日序号
+  float daySum;       // 当日倾角累加
+  uint16_t dayCount;  // 当日样本数
+  uint8_t head;       // 下一个写入位置
+  uint8_t count;      // 窗口内天数
+  uint16_t x[TREND_WINDOW_DAYS]; // 相对 baseDay 的天数
+  float y[TREND_WINDOW_DAYS];    // 日均倾角 (°)
+  double sx, sy, sxx, sxy;       // 回归累加量
+  uint32_t lastAlarmDay;
+  bool alarmed;
+};
+
+class TiltTrend {
+private:
+  static const uint32_t TREND_MAGIC = 0x54524E44; // "TRND"
+  static const uint32_t SECONDS_PER_DAY = 86400;
+
+  static TiltTrendState state; // RTC 内存（定义于 main.cpp）
+
+  static uint32_t today() { return rtcNowSeconds() / SECONDS_PER_DAY; }
+
+  static void ensureState() {
+    if (state.magic != TREND_MAGIC) {
+      memset(&state, 0, sizeof(state));
+      state.magic = TREND_MAGIC;
+      state.baseDay = today();
+      state.day = state.baseDay;
+    }
+  }
+
+  /**
+   * @brief 当日均值入窗（窗口满时先移出最早的一天）
+   */
+  static void commitDay() {
+    if (state.dayCount == 0) return;
+    double x = state.day - state.baseDay;
+    double y = state.daySum / state.dayCount;
+
+    if (state.count == TREND_WINDOW_DAYS) {
+      double ox = state.x[state.head];
+      double oy = state.y[state.head];
+      state.sx -= ox;
+      state.sy -= oy;
+      state.sxx -= ox * ox;
+      state.sxy -= ox * oy;
+    } else {
+      state.count++;
+    }
+    state.x[state.head] = (uint16_t)x;
+    state.y[state.head] = (float)y;
+    state.head = (state.head + 1) % TREND_WINDOW_DAYS;
+    state.sx += x;
+    state.sy += y;
+    state.sxx += x * x;
+    state.sxy += x * y;
+
+    state.daySum = 0.0f;
+    state.dayCount = 0;
+  }
+
+public:
+  /**
+   * @brief 记录一次巡检倾角
+   */
+  static void add(float angle) {
+#if ENABLE_TILT_TREND
+    if (angle < 0) return;
+    ensureState();
+    uint32_t now = today();
+    if (now != state.day) {
+      commitDay();
+      state.day = now;
+    }
+    state.daySum += angle;
+    if (state.dayCount < UINT16_MAX) state.dayCount++;
+#endif
+  }
+
+  /**
+   * @brief 回归斜率 (°/天)，样本不足返回 0
+   */
+  static float slopePerDay() {
+    ensureState();
+    double n = state.count;
+    double denom = n * state.sxx - state.sx * state.sx;
+    if (state.count < 2 || denom <= 0.0) return 0.0f;
+    return (float)((n * state.sxy - state.sx * state.sy) / denom);
+  }
+
+  /**
+   * @brief 拟合直线在今天的取值 (°)
+   */
+  static float fittedToday() {
+    ensureState();
+    if (state.count == 0) return 0.0f;
+    double meanX = state.sx / state.count;
+    double meanY = state.sy / state.count;
+    return (float)(meanY + slopePerDay() * ((double)(today() - state.baseDay) - meanX));
+  }
+
+  /**
+   * @brief 按当前趋势到达 TILT_THRESHOLD 的天数，无上升趋势返回 -1
+   */
+  static float daysToThreshold() {
+    float slope = slopePerDay();
+    if (slope < TREND_MIN_SLOPE_DEG_PER_DAY) return -1.0f;
+    float days = (TILT_THRESHOLD - fittedToday()) / slope;
+    return days > 0.0f ? days : 0.0f;
+  }
+
+  /**
+   * @brief 是否应发出蠕变报警（窗口足够长、预计天数进入范围、不在冷却期）
+   */
+  static bool isCreepAlarmDue() {
+#if ENABLE_TILT_TREND
+    ensureState();
+    if (state.count < TREND_MIN_DAYS) return false;
+    if (state.alarmed && today() - state.lastAlarmDay < TREND_ALARM_COOLDOWN_DAYS) return false;
+    float days = daysToThreshold();
+    if (days < 0 || days >= TREND_HORIZON_DAYS) return false;
+    DEBUG_PRINTF("[趋势] 🚨 蠕变 %.3f°/天，预计 %.0f 天后达到 %.1f°\n", slopePerDay(), days,
+                 TILT_THRESHOLD);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief 清空历史（零点重新校准后旧的日均值不再可比）
+   */
+  static void clear() {
+    state.magic = 0;
+    ensureState();
+  }
+
+  /**
+   * @brief 蠕变报警已送达，进入冷却期
+   */
+  static void markAlarmed() {
+    ensureState();
+    state.alarmed = true;
+    state.lastAlarmDay = today();
+  }
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * @file WakeHoldoff.h
+ * @brief 中断唤醒退避 - 连续误唤醒后暂停该唤醒源（RTC 内存）
+ *
+ * 杆体随风晃动时 IMU 唤醒中断会反复触发、持续环境噪音会反复触发 ULP，
+ * 每次都是一次完整启动。
+ * 两次巡检之间同一唤醒源误唤醒达到 limit 次后，在 holdoffSec 内不再装载它；
+ * 这段时间内的倾斜/声音仍由定时巡检（及唤醒桩）检查。巡检唤醒时计数清零。
+ */
+
+#include "../../include/AppConfig.h"
+#include "RtcClock.h"
+
+enum WakeSource : uint8_t {
+  WAKE_SRC_TILT = 0, // EXT1: LSM6DS3 INT1
+  WAKE_SRC_SOUND,    // ULP 声音监测
+  WAKE_SRC_COUNT
+};
+
+/**
+ * @brief RTC 状态（定义于 main.cpp）
+ */
+struct WakeHoldoffState {
+  uint32_t magic;
+  uint8_t falseWakes[WAKE_SRC_COUNT];    // 本巡检周期内误唤醒次数
+  uint32_t holdoffUntil[WAKE_SRC_COUNT]; // 暂停截止时刻 (RTC 秒)
+};
+
+class WakeHoldoff {
+private:
+  static const uint32_t HOLDOFF_MAGIC = 0x484F4C32; // "HOL2"（新增唤醒源时递增）
+
+  static WakeHoldoffState state; // RTC 内存（定义于 main.cpp）
+
+  static void ensureState() {
+    if (state.magic != HOLDOFF_MAGIC) {
+      memset(&state, 0, sizeof(state));
+      state.magic = HOLDOFF_MAGIC;
+    }
+  }
+
+public:
+  /**
+   * @brief 记录一次误唤醒，达到 limit 次后暂停该唤醒源 holdoffSec 秒
+   */
+  static void recordFalseWake(WakeSource src, uint8_t limit, uint32_t holdoffSec) {
+    ensureState();
+    if (++state.falseWakes[src] < limit) return;
+    state.falseWakes[src] = 0;
+    state.holdoffUntil[src] = rtcNowSeconds() + holdoffSec;
+    DEBUG_PRINTF("[唤醒] 连续 %u 次误唤醒，暂停唤醒源 %u 共 %lu 秒\n", limit, src,
+                 (unsigned long)holdoffSec);
+  }
+
+  /**
+   * @brief 巡检唤醒：清零误唤醒计数
+   */
+  static void resetFalseWakes() {
+    ensureState();
+    memset(state.falseWakes, 0, sizeof(state.falseWakes));
+  }
+
+  /**
+   * @brief 该唤醒源是否处于暂停期
+   */
+  static bool isHeldOff(WakeSource src) {
+    ensureState();
+    return rtcNowSeconds() < state.holdoffUntil[src];
+  }
+};
@@ -0,0 +1,274 @@
+#pragma once
+
+/**
+ * @file WakeProfiler.h
+ * @brief 唤醒周期分阶段耗时记录器（微秒精度，RTC 环形缓冲）
+ *
+ * 用法:
+ *   { ProfileSpan span(PHASE_GPS); gps->getLocation(...); }  // 作用域结束自动累计
+ *
+ * 设计说明:
+ *   - 每个唤醒周期累计各阶段耗时，deepSleep() 时提交到 RTC 环形缓冲
+ *   - 环形缓冲定义在 main.cpp（紧挨 bootCount），深度睡眠后保持
+ *   - 报警流水线中 GPS/网络/相机并行执行，各阶段之和可能大于周期总时长
+ *   - 心跳上报最近 PROFILER_REPORT_CYCLES 个周期的摘要（见 summaryJson）
+ *   - 启动基准：记录应用启动到首个传感器样本的时间 (time-to-first-sample)，
+ *     不含 ROM/引导程序耗时
+ */
+
+#include "../../include/AppConfig.h"
+#include "PowerManager.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdarg.h>
+
+/**
+ * @brief 唤醒阶段（顺序即上报数组顺序，只允许在末尾追加）
+ */
+enum WakePhase : uint8_t {
+  PHASE_BOOT = 0,    // 上电/唤醒 → setup() 完成启动横幅
+  PHASE_BATTERY,     // 电池电压采样
+  PHASE_TILT,        // 倾角读取
+  PHASE_AUDIO,       // 声音采样
+  PHASE_GPS,         // GPS 定位
+  PHASE_WIFI,        // WiFi 初始化与连接
+  PHASE_HTTP,        // HTTP 请求往返
+  PHASE_CAMERA,      // 相机初始化与拍照
+  PHASE_SLEEP_ENTRY, // 进入睡眠前的收尾
+  PHASE_COUNT
+};
+
+/**
+ * @brief 单个唤醒周期记录
+ */
+struct WakeCycleRecord {
+  uint32_t totalUs;               // 周期总时长
+  uint32_t phaseUs[PHASE_COUNT];  // 各阶段累计耗时
+  uint32_t firstSampleUs;         // 周期起点 → 首个传感器样本（0=本周期未采样）
+  uint16_t stateMs[STATE_COUNT];  // 状态机各状态耗时 (ms)，SLEEP 见 PHASE_SLEEP_ENTRY
+};
+
+// 记录位于 RTC 内存，旧固件写入的数据按新布局读出即为错位的垃圾值。
+// 增删字段（或 PHASE_COUNT/STATE_COUNT 变化）时须递增 RING_MAGIC，再更新此断言中的数值
+static_assert(PHASE_COUNT == 9 && STATE_COUNT == 8 && sizeof(WakeCycleRecord) == 60,
+              "WakeCycleRecord 布局已变化：请递增 WakeProfiler::RING_MAGIC");
+
+/**
+ * @brief RTC 环形缓冲
+ */
+struct WakeProfileRing {
+  uint32_t magic;  // 有效标记（首次上电时 RTC 内存为随机值）
+  uint8_t head;    // 下一个写入位置
+  uint8_t count;   // 有效记录数
+  WakeCycleRecord cycles[PROFILER_RING_SIZE];
+};
+
+class WakeProfiler {
+private:
+  static const uint32_t RING_MAGIC = 0x57414B32; // "WAK2"：+firstSampleUs、+stateMs（布局变化时递增）
+
+  static WakeProfileRing ring;           // RTC 内存（定义于 main.cpp）
+  static uint32_t current[PHASE_COUNT];  // 本周期累计（普通内存）
+  static uint16_t currentStateMs[STATE_COUNT]; // 本周期各状态耗时
+  static int64_t cycleStartUs;           // 本周期起点
+  static uint32_t firstSampleUs;         // 本周期首个样本时刻（相对起点）
+  static portMUX_TYPE lock;              // 并行任务同时累计时的保护
+
+public:
+  /**
+   * @brief 开始新周期（非深度睡眠测试模式下每轮循环调用）
+   */
+  static void beginCycle() {
+    portENTER_CRITICAL(&lock);
+    memset(current, 0, sizeof(current));
+    memset(currentStateMs, 0, sizeof(currentStateMs));
+    cycleStartUs = esp_timer_get_time();
+    firstSampleUs = 0;
+    portEXIT_CRITICAL(&lock);
+  }
+
+  /**
+   * @brief 标记启动完成（启动阶段 = 应用启动至此刻）
+   */
+  static void markBootComplete() {
+    ensureRing();
+    cycleStartUs = 0;
+    add(PHASE_BOOT, (uint32_t)esp_timer_get_time());
+  }
+
+  /**
+   * @brief 标记首个传感器样本已取得（每周期只记录第一次）
+   */
+  static void markFirstSample() {
+    if (firstSampleUs != 0) return;
+    firstSampleUs = (uint32_t)(esp_timer_get_time() - cycleStartUs);
+    DEBUG_PRINTF("[性能] 首个样本 %lu ms\n", (unsigned long)(firstSampleUs / 1000));
+  }
+
+  /**
+   * @brief 累计某阶段耗时
+   */
+  static void add(WakePhase phase, uint32_t us) {
+    if (phase >= PHASE_COUNT) return;
+    portENTER_CRITICAL(&lock);
+    current[phase] += us;
+    portEXIT_CRITICAL(&lock);
+  }
+
+  /**
+   * @brief 累计状态机某状态耗时（StateMachine 转换钩子调用）
+   */
+  static void addState(SystemState state, uint32_t ms) {
+    if (state >= STATE_COUNT) return;
+    currentStateMs[state] = (uint16_t)min(currentStateMs[state] + ms, (uint32_t)UINT16_MAX);
+  }
+
+  /**
+   * @brief 提交本周期到 RTC 环形缓冲（deepSleep 中调用）
+   */
+  static void endCycle() {
+    ensureRing();
+
+    WakeCycleRecord &rec = ring.cycles[ring.head];
+    portENTER_CRITICAL(&lock);
+    memcpy(rec.phaseUs, current, sizeof(current));
+    memcpy(rec.stateMs, currentStateMs, sizeof(currentStateMs));
+    rec.totalUs = (uint32_t)(esp_timer_get_time() - cycleStartUs);
+    rec.firstSampleUs = firstSampleUs;
+    portEXIT_CRITICAL(&lock);
+
+    ring.head = (ring.head + 1) % PROFILER_RING_SIZE;
+    if (ring.count < PROFILER_RING_SIZE) ring.count++;
+
+    DEBUG_PRINTF("[性能] 本周期 %lu ms (GPS %lu / WiFi %lu / HTTP %lu / 相机 %lu)\n",
+                 rec.totalUs / 1000, rec.phaseUs[PHASE_GPS] / 1000,
+                 rec.phaseUs[PHASE_WIFI] / 1000, rec.phaseUs[PHASE_HTTP] / 1000,
+                 rec.phaseUs[PHASE_CAMERA] / 1000);
+  }
+
+  /**
+   * @brief 获取最近第 n 个已提交周期（0=最近）
+   * @return nullptr=无记录
+   */
+  static const WakeCycleRecord *getCycle(uint8_t n) {
+    ensureRing();
+    if (n >= ring.count) return nullptr;
+    uint8_t idx = (ring.head + PROFILER_RING_SIZE - 1 - n) % PROFILER_RING_SIZE;
+    return &ring.cycles[idx];
+  }
+
+  static uint8_t getCycleCount() {
+    ensureRing();
+    return ring.count;
+  }
+
+  /**
+   * @brief 生成心跳用的紧凑摘要（单位 ms，数组顺序同 WakePhase）
+   *
+   * 格式: {"n":8,"tot":[平均,最近],"ttfs":[平均,最近],"avg":[...],"last":[...],
+   *        "st":[最近周期各状态耗时，顺序同 SystemState]}
+   */
+  static String summaryJson() {
+    uint8_t n = getCycleCount();
+    if (n > PROFILER_REPORT_CYCLES) n = PROFILER_REPORT_CYCLES;
+    if (n == 0) return String();
+
+    uint32_t sum[PHASE_COUNT] = {0};
+    uint32_t sumTotal = 0;
+    uint32_t sumFirst = 0;
+    uint8_t nFirst = 0;
+    for (uint8_t i = 0; i < n; i++) {
+      const WakeCycleRecord *rec = getCycle(i);
+      sumTotal += rec->totalUs / 1000;
+      if (rec->firstSampleUs) {
+        sumFirst += rec->firstSampleUs / 1000;
+        nFirst++;
+      }
+      for (uint8_t p = 0; p < PHASE_COUNT; p++) {
+        sum[p] += rec->phaseUs[p] / 1000;
+      }
+    }
+    const WakeCycleRecord *last = getCycle(0);
+
+    char buf[288];
+    size_t len = 0;
+    bool ok = appendf(buf, sizeof(buf), len,
+                      "{\"n\":%u,\"tot\":[%lu,%lu],\"ttfs\":[%lu,%lu],\"avg\":[",
+                      n, (unsigned long)(sumTotal / n),
+                      (unsigned long)(last->totalUs / 1000),
+                      (unsigned long)(nFirst ? sumFirst / nFirst : 0),
+                      (unsigned long)(last->firstSampleUs / 1000));
+    for (uint8_t p = 0; p < PHASE_COUNT && ok; p++) {
+      ok = appendf(buf, sizeof(buf), len, p ? ",%lu" : "%lu", (unsigned long)(sum[p] / n));
+    }
+    ok = ok && appendf(buf, sizeof(buf), len, "],\"last\":[");
+    for (uint8_t p = 0; p < PHASE_COUNT && ok; p++) {
+      ok = appendf(buf, sizeof(buf), len, p ? ",%lu" : "%lu",
+                   (unsigned long)(last->phaseUs[p] / 1000));
+    }
+    ok = ok && appendf(buf, sizeof(buf), len, "],\"st\":[");
+    for (uint8_t s = 0; s < STATE_COUNT && ok; s++) {
+      ok = appendf(buf, sizeof(buf), len, s ? ",%u" : "%u", (unsigned)last->stateMs[s]);
+    }
+    ok = ok && appendf(buf, sizeof(buf), len, "]}");
+    if (!ok) {
+      DEBUG_PRINTLN("[剖析] ⚠️ 摘要超出缓冲，本次不上报");
+      return String(); // 截断的 JSON 无法解析，不如不带
+    }
+    return String(buf);
+  }
+
+private:
+  /**
+   * @brief 追加格式化文本，len 始终不超过 size-1
+   * @return false=空间不足（已截断，之后不应再追加）
+   */
+  static bool appendf(char *buf, size_t size, size_t &len, const char *fmt, ...) {
+    if (len >= size - 1) return false;
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(buf + len, size - len, fmt, args);
+    va_end(args);
+    if (written < 0 || (size_t)written >= size - len) {
+      len = size - 1;
+      return false;
+    }
+    len += written;
+    return true;
+  }
+
+  static void ensureRing() {
+    if (ring.magic != RING_MAGIC || ring.head >= PROFILER_RING_SIZE ||
+        ring.count > PROFILER_RING_SIZE) {
+      memset(&ring, 0, sizeof(ring));
+      ring.magic = RING_MAGIC;
+    }
+  }
+};
+
+/**
+ * @brief 作用域计时：构造时开始，析构时累计到对应阶段
+ * @note 同时按阶段申请/释放电源策略（见 PowerManager.h）
+ */
+class ProfileSpan {
+private:
+  WakePhase phase;
+  int64_t startUs;
+
+public:
+  explicit ProfileSpan(WakePhase p) : phase(p) {
+    PowerManager::enter(phase);
+    startUs = esp_timer_get_time();
+  }
+  ~ProfileSpan() {
+    WakeProfiler::add(phase, (uint32_t)(esp_timer_get_time() - startUs));
+    PowerManager::exit(phase);
+  }
+};
+
+// 静态成员初始化（ring 位于 RTC 内存，定义于 main.cpp）
+uint32_t WakeProfiler::current[PHASE_COUNT] = {0};
+uint16_t WakeProfiler::currentStateMs[STATE_COUNT] = {0};
+int64_t WakeProfiler::cycleStartUs = 0;
+uint32_t WakeProfiler::firstSampleUs = 0;
+portMUX_TYPE WakeProfiler::lock = portMUX_INITIALIZER_UNLOCKED;
@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * @file Arduino.h
+ * @brief 主机端测试用的最小 Arduino 替身（native 环境，见 platformio.ini）
+ *
+ * 只提供纯算法头文件（TiltFusion / TiltTrend / Sharpness 等）经 AppConfig.h
+ * 间接用到的符号；串口输出全部丢弃。依赖外设的头文件不应在主机端包含。
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+struct NativeSerialStub {
+  void print(...) {}
+  void println(...) {}
+  int printf(const char *, ...) { return 0; }
+};
+static NativeSerialStub Serial __attribute__((unused));
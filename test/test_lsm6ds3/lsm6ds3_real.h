@@ -7,6 +7,7 @@
  *   - 传感器初始化
  *   - 实时数据读取
  *   - 采样稳定性验证
+ *   - FIFO 突发读取（经驱动 LSM6DS3_Sensor::drainFifo）
  */
 
 #ifndef LSM6DS3_REAL_H
@@ -19,12 +20,45 @@
 #include <Wire.h>
 #include <unity.h>
 
+// 驱动经 AppConfig.h 会重定义 USE_MOCK_HARDWARE，保留命令行给定的测试模式
+#pragma push_macro("USE_MOCK_HARDWARE")
+#undef USE_MOCK_HARDWARE
+#include "../../src/modules/real/LSM6DS3_Sensor.h"
+#pragma pop_macro("USE_MOCK_HARDWARE")
+
 // 测试配置
 #define LSM6DS3_I2C_ADDR 0x6A
 
 // 全局传感器对象
 extern LSM6DS3 imu;
 
+// 被测驱动（FIFO 缓存约 3 KB，不放在栈上）
+static LSM6DS3_Sensor fifoSensor;
+
+/**
+ * @brief 驱动保留的 FIFO 样本三轴均值 (g)，并检查每个样本总加速度接近 1g
+ */
+static void fifoMean(float mean[3]) {
+  mean[0] = mean[1] = mean[2] = 0.0f;
+  size_t n = fifoSensor.getFifoCount();
+  for (size_t i = 0; i < n; i++) {
+    const int16_t *s = fifoSensor.getFifoSample(i);
+    float a[3];
+    for (int axis = 0; axis < 3; axis++) {
+      a[axis] = s[axis] * LSM6DS3_ACCEL_G_PER_LSB;
+      mean[axis] += a[axis] / n;
+    }
+    float magnitude = sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.3f, 1.0f, magnitude, "FIFO 样本总加速度接近 1g");
+  }
+}
+
+static void assertSameOrientation(const float ref[3], const float mean[3], const char *msg) {
+  for (int axis = 0; axis < 3; axis++) {
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.1f, ref[axis], mean[axis], msg);
+  }
+}
+
 // ==================== Real 测试用例 ====================
 
 /**
@@ -143,4 +177,60 @@ void test_real_sampling_stability() {
   Serial.println("✓ 采样稳定");
 }
 
+/**
+ * @brief Real测试：FIFO 连续模式 + 突发读取（LSM6DS3_Sensor::drainFifo）
+ *
+ * 传感器须静止放置。覆盖驱动中的：
+ *   - 突发读取结束后恢复调用前的 I2C 时钟
+ *   - 读指针停在样本中间（模式位置 ≠ 0）时先跳到下一个 X 轴
+ *   - FIFO 写满后 FIFO_STATUS2 的标志位不计入 12 位未读字数
+ */
+void test_real_fifo_burst_read() {
+  Serial.println("\n[TEST] Real: FIFO 突发读取");
+
+  TEST_ASSERT_TRUE_MESSAGE(fifoSensor.init(), "驱动初始化（写入 FIFO 连续模式配置）");
+  fifoSensor.drainFifo(); // 丢弃初始化前的积压
+  delay(1000);
+
+  // 1. 基本读取 + 时钟恢复（探测值与 IMU_I2C_HZ / IMU_I2C_BURST_HZ 均不同）
+  const uint32_t probeClock = 200000;
+  Wire.setClock(probeClock);
+  size_t n = fifoSensor.drainFifo();
+  TEST_ASSERT_EQUAL_MESSAGE(probeClock, Wire.getClock(), "排空后恢复调用前的 I2C 时钟");
+  Serial.printf("  1 秒后读出 %u 样本 (期望 ~26)\n", (unsigned)n);
+  TEST_ASSERT_TRUE_MESSAGE(n >= 20, "1 秒内累积约 26 个样本");
+  float ref[3];
+  fifoMean(ref);
+  Serial.printf("  参考均值: X=%.2f, Y=%.2f, Z=%.2f (g)\n", ref[0], ref[1], ref[2]);
+
+  // 2. 模式位置：多读一个字让读指针停在 Y 轴，驱动应跳过 Y/Z 而不是把轴错位
+  delay(500);
+  Wire.beginTransmission(fifoSensor.getAddress());
+  Wire.write(LSM6DS3_FIFO_DATA_OUT_L);
+  Wire.endTransmission(false);
+  Wire.requestFrom(fifoSensor.getAddress(), (uint8_t)2);
+  while (Wire.available()) Wire.read();
+  delay(500);
+  n = fifoSensor.drainFifo();
+  TEST_ASSERT_TRUE_MESSAGE(n >= 10, "错位后仍能读出样本");
+  float mean[3];
+  fifoMean(mean);
+  assertSameOrientation(ref, mean, "错位后三轴均值不变（已对齐到 X 轴）");
+
+  // 3. 溢出：LSM6DS3 FIFO 最多 4096 字（≈1365 样本，26 Hz 下约 53 s）
+  Serial.println("  等待 FIFO 写满 (55 s)...");
+  delay(55000);
+  uint32_t t0 = millis();
+  n = fifoSensor.drainFifo();
+  Serial.printf("  溢出后读出并保留 %u 样本，耗时 %lu ms\n", (unsigned)n,
+                (unsigned long)(millis() - t0));
+  TEST_ASSERT_EQUAL_MESSAGE(IMU_FIFO_MAX_SAMPLES, n, "保留最新 IMU_FIFO_MAX_SAMPLES 个样本");
+  TEST_ASSERT_TRUE_MESSAGE(millis() - t0 < 1000, "未把标志位当作字数（读取量有界）");
+  fifoMean(mean);
+  assertSameOrientation(ref, mean, "溢出后三轴均值不变");
+  TEST_ASSERT_EQUAL_MESSAGE(probeClock, Wire.getClock(), "溢出路径同样恢复 I2C 时钟");
+
+  Serial.println("✓ FIFO 突发读取正常");
+}
+
 #endif // LSM6DS3_REAL_H
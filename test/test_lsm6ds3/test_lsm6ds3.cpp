@@ -64,6 +64,7 @@ void setup() {
   RUN_TEST(test_real_accel_reading);
   RUN_TEST(test_real_angle_calculation);
   RUN_TEST(test_real_sampling_stability);
+  RUN_TEST(test_real_fifo_burst_read);
 
 #endif
 
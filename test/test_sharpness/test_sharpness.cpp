@@ -0,0 +1,112 @@
+/**
+ * @file test_sharpness.cpp
+ * @brief 图像清晰度评分 (Sharpness) 的主机端测试
+ *
+ * 测试目标：
+ *   1. 平坦图像上 noiseSigma 接近注入噪声的 σ
+ *   2. 噪声扣除后，清晰帧得分高于模糊噪点帧（原始拉普拉斯方差恰好相反）
+ *   3. 无噪声时 score 与拉普拉斯方差基本一致
+ *   4. 过小的图像返回 0
+ *
+ * 运行方式（无需硬件）：
+ *   pio test -e native-algo
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "../../src/utils/Sharpness.h"
+
+static const int W = 96; // 与连拍评分的降采样灰度图同量级
+static const int H = 72;
+
+static uint32_t rng = 1;
+
+// 标准正态分布（Box-Muller，固定种子，结果可复现）
+static float gauss() {
+  rng = rng * 1103515245u + 12345u;
+  float u1 = (((rng >> 8) & 0xFFFF) + 1) / 65537.0f;
+  rng = rng * 1103515245u + 12345u;
+  float u2 = ((rng >> 8) & 0xFFFF) / 65536.0f;
+  return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * 3.14159265f * u2);
+}
+
+static uint8_t clamp8(float v) { return v < 0.0f ? 0 : v > 255.0f ? 255 : (uint8_t)lroundf(v); }
+
+// 8×8 像素方格的棋盘（64 / 192）
+static void checkerboard(float *img) {
+  for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++) img[y * W + x] = ((x / 8 + y / 8) & 1) ? 192.0f : 64.0f;
+}
+
+// 5×5 均值模糊（模拟运动/失焦模糊），边缘像素保持原值
+static void boxBlur(float *img) {
+  static float tmp[W * H];
+  memcpy(tmp, img, sizeof(tmp));
+  for (int y = 2; y < H - 2; y++)
+    for (int x = 2; x < W - 2; x++) {
+      float s = 0.0f;
+      for (int dy = -2; dy <= 2; dy++)
+        for (int dx = -2; dx <= 2; dx++) s += tmp[(y + dy) * W + x + dx];
+      img[y * W + x] = s / 25.0f;
+    }
+}
+
+static void render(const float *img, float sigma, uint8_t *out) {
+  for (int i = 0; i < W * H; i++) out[i] = clamp8(img[i] + sigma * gauss());
+}
+
+void setUp(void) { rng = 1; }
+
+void tearDown(void) {}
+
+void test_noise_sigma_on_flat_image(void) {
+  static float img[W * H];
+  static uint8_t gray[W * H];
+  for (int i = 0; i < W * H; i++) img[i] = 128.0f;
+  render(img, 10.0f, gray);
+  TEST_ASSERT_FLOAT_WITHIN(1.5f, 10.0f, Sharpness::noiseSigma(gray, W, H));
+}
+
+void test_noisy_blur_loses_to_clean_sharp(void) {
+  static float sharpImg[W * H];
+  static float blurImg[W * H];
+  static uint8_t sharp[W * H];
+  static uint8_t blurred[W * H];
+  checkerboard(sharpImg);
+  checkerboard(blurImg);
+  boxBlur(blurImg);
+  render(sharpImg, 2.0f, sharp);    // 光线充足：低增益
+  render(blurImg, 25.0f, blurred);  // 弱光：高增益 + 抖动模糊
+
+  // 原始方差把噪点误判为细节
+  TEST_ASSERT_GREATER_THAN_FLOAT(Sharpness::laplacianVariance(sharp, W, H),
+                                 Sharpness::laplacianVariance(blurred, W, H));
+  // 扣除噪声后清晰帧胜出
+  TEST_ASSERT_GREATER_THAN_FLOAT(Sharpness::score(blurred, W, H), Sharpness::score(sharp, W, H));
+}
+
+void test_clean_image_score_matches_variance(void) {
+  static float img[W * H];
+  static uint8_t gray[W * H];
+  checkerboard(img);
+  render(img, 0.0f, gray);
+  float var = Sharpness::laplacianVariance(gray, W, H);
+  TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, var);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f * var, var, Sharpness::score(gray, W, H));
+}
+
+void test_tiny_image_returns_zero(void) {
+  uint8_t gray[4] = {0, 255, 255, 0};
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, Sharpness::score(gray, 2, 2));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, Sharpness::score(nullptr, W, H));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_noise_sigma_on_flat_image);
+  RUN_TEST(test_noisy_blur_loses_to_clean_sharp);
+  RUN_TEST(test_clean_image_score_matches_variance);
+  RUN_TEST(test_tiny_image_returns_zero);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+/**
+ * @file test_tilt_fusion.cpp
+ * @brief 陀螺仪 + 加速度计互补滤波 (TiltFusion) 的主机端测试
+ *
+ * 测试目标：
+ *   1. 静止时收敛到加速度计角度
+ *   2. 风摆 + 侧向线加速度下，融合倾角贴近真实倾角，加速度计单独解算偏差数度
+ *   3. |a| 偏离 1g 超过门限的样本不做加速度修正
+ *   4. 滚转轴方向约定与 LSM6DS3_Sensor::anglesFrom 一致
+ *
+ * 运行方式（无需硬件）：
+ *   pio test -e native-algo
+ */
+
+#include <unity.h>
+#include "../../src/utils/TiltFusion.h"
+
+static const float DT = 1.0f / 104.0f; // 防抖窗口采样率 104 Hz
+static const float DEG = PI / 180.0f;
+
+// 真实俯仰角：3° 静态倾斜 + 0.5° / 1 Hz 风摆
+static float truePitch(float t) { return 3.0f + 0.5f * sinf(2.0f * PI * 1.0f * t); }
+
+static float truePitchRate(float t) { return 0.5f * 2.0f * PI * 1.0f * cosf(2.0f * PI * t); }
+
+// 重力在传感器坐标系的分量（只有俯仰）+ X 向线加速度 (g)
+static void accelFor(float pitchDeg, float lateralG, float &ax, float &ay, float &az) {
+  ax = sinf(pitchDeg * DEG) + lateralG;
+  ay = 0.0f;
+  az = cosf(pitchDeg * DEG);
+}
+
+static float accelPitch(float ax, float ay, float az) {
+  return atan2f(ax, sqrtf(ay * ay + az * az)) / DEG;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_static_converges_to_accel(void) {
+  TiltFusion fusion;
+  fusion.reset(0.0f, 0.0f); // 初值偏 4°
+  float ax, ay, az;
+  accelFor(4.0f, 0.0f, ax, ay, az);
+  for (int i = 0; i < 104 * 5; i++) fusion.update(ax, ay, az, 0.0f, 0.0f, DT); // 5τ
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 4.0f, fusion.getPitch());
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, fusion.getRoll());
+}
+
+void test_sway_and_vibration_rejected(void) {
+  TiltFusion fusion;
+  fusion.reset(truePitch(0.0f), 0.0f);
+
+  float maxFusedErr = 0.0f;
+  float maxAccelErr = 0.0f;
+  for (int i = 1; i <= 52; i++) { // 防抖窗口 < 0.5 s
+    float t = i * DT;
+    float lateral = 0.08f * sinf(2.0f * PI * 4.0f * t); // 4 Hz 车辆振动
+    float ax, ay, az;
+    accelFor(truePitch(t), lateral, ax, ay, az);
+    fusion.update(ax, ay, az, 0.0f, -truePitchRate(t), DT); // pitch 变化率 = -gy
+
+    maxFusedErr = fmaxf(maxFusedErr, fabsf(fusion.getPitch() - truePitch(t)));
+    maxAccelErr = fmaxf(maxAccelErr, fabsf(accelPitch(ax, ay, az) - truePitch(t)));
+  }
+
+  TEST_ASSERT_LESS_THAN_FLOAT(0.4f, maxFusedErr);
+  TEST_ASSERT_GREATER_THAN_FLOAT(3.0f, maxAccelErr);
+}
+
+void test_accel_gate_skips_correction(void) {
+  TiltFusion fusion;
+  fusion.reset(2.0f, 0.0f);
+  // |a| = 1.3g，超出 TILT_FUSION_ACCEL_GATE_G：只积分陀螺仪（此处为 0）
+  for (int i = 0; i < 104; i++) fusion.update(0.6f, 0.0f, 1.15f, 0.0f, 0.0f, DT);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.0f, fusion.getPitch());
+}
+
+void test_roll_axis_convention(void) {
+  TiltFusion fusion;
+  fusion.reset(0.0f, 0.0f);
+  // 绕 X 轴 +10°/s 转 1 s，加速度计同步给出 roll=10°
+  for (int i = 1; i <= 104; i++) {
+    float roll = 10.0f * i * DT;
+    fusion.update(0.0f, sinf(roll * DEG), cosf(roll * DEG), 10.0f, 0.0f, DT);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 10.0f, fusion.getRoll());
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, fusion.getPitch());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_static_converges_to_accel);
+  RUN_TEST(test_sway_and_vibration_rejected);
+  RUN_TEST(test_accel_gate_skips_correction);
+  RUN_TEST(test_roll_axis_convention);
+  return UNITY_END();
+}
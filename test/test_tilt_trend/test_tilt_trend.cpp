@@ -0,0 +1,113 @@
+/**
+ * @file test_tilt_trend.cpp
+ * @brief 倾角缓慢蠕变检测 (TiltTrend) 的主机端测试
+ *
+ * 测试目标：
+ *   1. 每周 0.1° 的蠕变（±0.15° 噪声）在越过 TILT_THRESHOLD 之前发出报警，预计天数接近真实值
+ *   2. 平稳序列（同样噪声）从不报警
+ *   3. markAlarmed 后 TREND_ALARM_COOLDOWN_DAYS 天内不重复报警
+ *   4. 窗口满后滑出旧数据，斜率跟随新趋势
+ *
+ * RTC 时钟由 g_mockRtcSeconds 模拟（RTC_CLOCK_MOCK）。
+ *
+ * 运行方式（无需硬件）：
+ *   pio test -e native-algo
+ */
+
+#include <unity.h>
+#include "../../src/utils/TiltTrend.h"
+
+uint32_t g_mockRtcSeconds = 0;
+TiltTrendState TiltTrend::state;
+
+static const uint32_t DAY_SEC = 86400;
+static const int PATROLS_PER_DAY = 4;
+static const float START_DEG = 3.0f;
+static const float CREEP_DEG_PER_DAY = 0.1f / 7.0f;
+
+static uint32_t rng = 1;
+
+// 均匀噪声 [-amp, amp]（固定种子，结果可复现）
+static float noise(float amp) {
+  rng = rng * 1103515245u + 12345u;
+  return amp * (((rng >> 8) & 0xFFFF) / 32767.5f - 1.0f);
+}
+
+// 模拟一天的巡检
+static void patrolDay(float trueDeg) {
+  for (int i = 0; i < PATROLS_PER_DAY; i++) {
+    TiltTrend::add(trueDeg + noise(0.15f));
+    g_mockRtcSeconds += DAY_SEC / PATROLS_PER_DAY;
+  }
+}
+
+void setUp(void) {
+  g_mockRtcSeconds = 1000 * DAY_SEC;
+  TiltTrend::clear();
+  rng = 1;
+}
+
+void tearDown(void) {}
+
+void test_creep_alarm_before_threshold(void) {
+  int alarmDay = -1;
+  float projected = -1.0f;
+  for (int d = 0; d < 200 && alarmDay < 0; d++) {
+    patrolDay(START_DEG + CREEP_DEG_PER_DAY * d);
+    if (TiltTrend::isCreepAlarmDue()) {
+      alarmDay = d;
+      projected = TiltTrend::daysToThreshold();
+    }
+  }
+
+  float trueCrossDay = (TILT_THRESHOLD - START_DEG) / CREEP_DEG_PER_DAY; // 140 天
+  TEST_ASSERT_TRUE(alarmDay >= TREND_MIN_DAYS);
+  TEST_ASSERT_TRUE(alarmDay < trueCrossDay);
+  TEST_ASSERT_LESS_THAN_FLOAT((float)TREND_HORIZON_DAYS, projected);
+  TEST_ASSERT_FLOAT_WITHIN(10.0f, trueCrossDay - alarmDay, projected);
+  TEST_ASSERT_FLOAT_WITHIN(0.003f, CREEP_DEG_PER_DAY, TiltTrend::slopePerDay());
+}
+
+void test_flat_series_never_alarms(void) {
+  for (int d = 0; d < 365; d++) {
+    patrolDay(START_DEG);
+    TEST_ASSERT_FALSE(TiltTrend::isCreepAlarmDue());
+  }
+  TEST_ASSERT_LESS_THAN_FLOAT(TREND_MIN_SLOPE_DEG_PER_DAY, TiltTrend::slopePerDay());
+}
+
+void test_cooldown_after_alarm(void) {
+  int d = 0;
+  while (!TiltTrend::isCreepAlarmDue()) {
+    patrolDay(START_DEG + CREEP_DEG_PER_DAY * d++);
+    TEST_ASSERT_TRUE(d < 200);
+  }
+  TiltTrend::markAlarmed();
+
+  for (int i = 1; i < TREND_ALARM_COOLDOWN_DAYS; i++) {
+    patrolDay(START_DEG + CREEP_DEG_PER_DAY * d++);
+    TEST_ASSERT_FALSE(TiltTrend::isCreepAlarmDue());
+  }
+  patrolDay(START_DEG + CREEP_DEG_PER_DAY * d++);
+  TEST_ASSERT_TRUE(TiltTrend::isCreepAlarmDue());
+}
+
+void test_window_slides_to_new_trend(void) {
+  // 先上升 60 天，再平稳 TREND_WINDOW_DAYS 天：旧的上升段应全部滑出窗口
+  for (int d = 0; d < 60; d++) patrolDay(START_DEG + CREEP_DEG_PER_DAY * d);
+  TEST_ASSERT_GREATER_THAN_FLOAT(TREND_MIN_SLOPE_DEG_PER_DAY, TiltTrend::slopePerDay());
+
+  float plateau = START_DEG + CREEP_DEG_PER_DAY * 60;
+  for (int d = 0; d < TREND_WINDOW_DAYS + 1; d++) patrolDay(plateau);
+  TEST_ASSERT_FLOAT_WITHIN(0.002f, 0.0f, TiltTrend::slopePerDay());
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, plateau, TiltTrend::fittedToday());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_creep_alarm_before_threshold);
+  RUN_TEST(test_flat_series_never_alarms);
+  RUN_TEST(test_cooldown_after_alarm);
+  RUN_TEST(test_window_slides_to_new_trend);
+  return UNITY_END();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file test_ulp_sim.cpp
+ * @brief ULP 声音监测判定逻辑的主机端测试
+ *
+ * 测试目标：
+ *   1. enable=0 时不采样、不唤醒
+ *   2. 安静环境不唤醒
+ *   3. 单次突发声音被去抖，不唤醒
+ *   4. 持续声音在 TRIGGER 次运行后唤醒
+ *   5. 滑动平均收敛到峰峰值
+ *   6. 满量程输入下 16 位累加器不溢出
+ *
+ * 运行方式（无需硬件）：
+ *   pio test -e native-ulp
+ */
+
+#include <unity.h>
+#include "../../src/core/UlpSoundLogic.h"
+
+static const size_t BURST = 16;
+static const uint8_t SHIFT = 3;
+static const uint16_t TRIGGER = 2;
+static const uint16_t THRESHOLD = 200;
+
+static UlpSoundState state;
+
+// 以 2048 为中心、给定峰峰值的三角波突发
+static void makeBurst(uint16_t *burst, uint16_t p2p) {
+  for (size_t i = 0; i < BURST; i++) {
+    int phase = (int)(i % 4);
+    int offset = (phase == 0) ? 0 : (phase == 1) ? p2p / 2 : (phase == 2) ? 0 : -(p2p / 2);
+    burst[i] = (uint16_t)(2048 + offset);
+  }
+}
+
+static bool run(uint16_t p2p) {
+  uint16_t burst[BURST];
+  makeBurst(burst, p2p);
+  return ulpSoundStep(state, burst, BURST, SHIFT, TRIGGER);
+}
+
+void setUp(void) {
+  state = UlpSoundState();
+  state.enable = 1;
+  state.threshold = THRESHOLD;
+}
+
+void tearDown(void) {}
+
+void test_disabled_never_wakes(void) {
+  state.enable = 0;
+  for (int i = 0; i < 50; i++) TEST_ASSERT_FALSE(run(4000));
+  TEST_ASSERT_EQUAL_UINT16(0, state.acc);
+  TEST_ASSERT_EQUAL_UINT16(0, state.level);
+}
+
+void test_quiet_never_wakes(void) {
+  for (int i = 0; i < 500; i++) TEST_ASSERT_FALSE(run(40));
+  TEST_ASSERT_EQUAL_UINT16(0, state.hits);
+}
+
+void test_single_loud_burst_debounced(void) {
+  for (int i = 0; i < 50; i++) run(40); // 稳态 acc = 40 << 3 = 320
+
+  // 突发使 level 只越过阈值一次: acc = 320 - 40 + 1400 = 1680, level = 210
+  TEST_ASSERT_FALSE(run(1400));
+  TEST_ASSERT_EQUAL_UINT16(1, state.hits);
+
+  // 下一次回落: acc = 1680 - 210 + 40 = 1510, level = 188
+  TEST_ASSERT_FALSE(run(40));
+  TEST_ASSERT_EQUAL_UINT16(0, state.hits);
+}
+
+void test_sustained_loud_wakes_after_trigger(void) {
+  for (int i = 0; i < 50; i++) run(40);
+  int runs = 0;
+  bool woke = false;
+  while (!woke && runs < 100) {
+    woke = run(1000);
+    runs++;
+  }
+  TEST_ASSERT_TRUE(woke);
+  TEST_ASSERT_EQUAL_UINT16(TRIGGER, state.hits);
+  TEST_ASSERT_GREATER_THAN_UINT16(THRESHOLD, state.level);
+}
+
+void test_level_converges_to_p2p(void) {
+  for (int i = 0; i < 200; i++) run(600);
+  // 稳态 acc = p2p << shift，level 截断误差小于 1
+  TEST_ASSERT_UINT16_WITHIN(1, 600, state.level);
+}
+
+void test_full_scale_no_overflow(void) {
+  uint16_t burst[BURST];
+  for (size_t i = 0; i < BURST; i++) burst[i] = (i & 1) ? 4095 : 0;
+  state.threshold = 0xFFFF; // 只看累加器
+  for (int i = 0; i < 500; i++) ulpSoundStep(state, burst, BURST, SHIFT, TRIGGER);
+  // 4095 << 3 = 32760 < 65536
+  TEST_ASSERT_UINT16_WITHIN(1, 4095, state.level);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_disabled_never_wakes);
+  RUN_TEST(test_quiet_never_wakes);
+  RUN_TEST(test_single_loud_burst_debounced);
+  RUN_TEST(test_sustained_loud_wakes_after_trigger);
+  RUN_TEST(test_level_converges_to_p2p);
+  RUN_TEST(test_full_scale_no_overflow);
+  return UNITY_END();
+}